@@ -0,0 +1,505 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <geometry>
+
+// the operators of vec_ops.h and mat_ops.h, invert, transpose and the
+// conversions, for float, double and int; the results are printed as JSON,
+// in the format of Google Benchmark so that its tools can compare two runs
+//
+// usage: bench_geometry [filter], only the benchmarks whose name contains
+// the filter are run
+
+namespace {
+
+  using hmi::mat;
+  using hmi::vec;
+
+  constexpr std::size_t COUNT = 1024;
+  constexpr int REPETITIONS = 5;
+  constexpr double MIN_TIME = 0.01; // seconds per repetition
+
+  struct result {
+    std::string name;
+    std::size_t iterations;
+    double real_time; // ns per operation
+    double cpu_time;
+  };
+
+  std::vector<result> g_results;
+  std::string g_filter;
+
+  template<typename T>
+  volatile T g_sink;
+
+  template<typename Function>
+  void run(const std::string& name, Function function) {
+    if (name.find(g_filter) == std::string::npos) {
+      return;
+    }
+
+    // enough rounds to last MIN_TIME, then the median of the repetitions
+    std::size_t rounds = 1;
+
+    for (;;) {
+      auto start = std::chrono::steady_clock::now();
+
+      for (std::size_t round = 0; round < rounds; ++round) {
+        function();
+      }
+
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      if (elapsed.count() >= MIN_TIME) {
+        break;
+      }
+
+      rounds *= 2;
+    }
+
+    std::vector<result> repetitions;
+
+    for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+      std::clock_t cpu_start = std::clock();
+      auto start = std::chrono::steady_clock::now();
+
+      for (std::size_t round = 0; round < rounds; ++round) {
+        function();
+      }
+
+      auto end = std::chrono::steady_clock::now();
+      std::clock_t cpu_end = std::clock();
+
+      const double operations = static_cast<double>(rounds * COUNT);
+      double real_time = std::chrono::duration<double, std::nano>(end - start).count() / operations;
+      double cpu_time = 1e9 * static_cast<double>(cpu_end - cpu_start) / CLOCKS_PER_SEC / operations;
+      repetitions.push_back({ name, rounds * COUNT, real_time, cpu_time });
+    }
+
+    std::sort(repetitions.begin(), repetitions.end(), [](const result& lhs, const result& rhs) {
+      return lhs.real_time < rhs.real_time;
+    });
+
+    g_results.push_back(repetitions[REPETITIONS / 2]);
+  }
+
+  // names and values
+
+  template<typename T>
+  const char *suffix();
+
+  template<>
+  const char *suffix<float>() {
+    return "f";
+  }
+
+  template<>
+  const char *suffix<double>() {
+    return "d";
+  }
+
+  template<>
+  const char *suffix<int>() {
+    return "i";
+  }
+
+  template<typename T, std::size_t N>
+  std::string type_name() {
+    return "vec" + std::to_string(N) + suffix<T>();
+  }
+
+  template<typename T, std::size_t R, std::size_t C>
+  std::string mat_name() {
+    if (R == C) {
+      return "mat" + std::to_string(R) + suffix<T>();
+    }
+
+    return "mat" + std::to_string(R) + "x" + std::to_string(C) + suffix<T>();
+  }
+
+  // small non-zero values: no overflow and no division by zero for int
+  template<typename T>
+  T value(std::size_t i) {
+    return static_cast<T>(1 + i % 3);
+  }
+
+  template<typename T, std::size_t N>
+  vec<T, N> make_vec(std::size_t i) {
+    vec<T, N> result;
+
+    for (std::size_t k = 0; k < N; ++k) {
+      result.data[k] = value<T>(i + k);
+    }
+
+    return result;
+  }
+
+  // diagonally dominant, so that the square matrices are invertible
+  template<typename T, std::size_t R, std::size_t C>
+  mat<T, R, C> make_mat(std::size_t i) {
+    mat<T, R, C> result;
+
+    for (std::size_t row = 0; row < R; ++row) {
+      for (std::size_t col = 0; col < C; ++col) {
+        result.data[row][col] = value<T>(i + row * C + col) + (row == col ? T(16) : T(0));
+      }
+    }
+
+    return result;
+  }
+
+  template<typename Value, typename Make>
+  std::vector<Value> make_values(Make make) {
+    std::vector<Value> result;
+
+    for (std::size_t i = 0; i < COUNT; ++i) {
+      result.push_back(make(i));
+    }
+
+    return result;
+  }
+
+  // vectors
+
+  template<typename T, std::size_t N>
+  void bench_vec() {
+    using V = vec<T, N>;
+
+    const std::vector<V> a = make_values<V>(make_vec<T, N>);
+    const std::vector<V> b = make_values<V>([](std::size_t i) { return make_vec<T, N>(i + 1); });
+    const std::vector<T> s = make_values<T>(value<T>);
+    std::vector<V> out(COUNT);
+    std::vector<char> flags(COUNT);
+
+    const std::string name = type_name<T, N>();
+
+    auto binary = [&](const char *operation, auto function) {
+      run(name + "/" + operation, [&]() {
+        for (std::size_t i = 0; i < COUNT; ++i) {
+          out[i] = function(a[i], b[i], s[i]);
+        }
+
+        g_sink<T> = out[COUNT / 2][0];
+      });
+    };
+
+    // the compound assignments update a copy of the lhs
+    auto compound = [&](const char *operation, auto function) {
+      run(name + "/" + operation, [&]() {
+        for (std::size_t i = 0; i < COUNT; ++i) {
+          out[i] = a[i];
+          function(out[i], b[i], s[i]);
+        }
+
+        g_sink<T> = out[COUNT / 2][0];
+      });
+    };
+
+    run(name + "/operator==", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        flags[i] = a[i] == b[i];
+      }
+
+      g_sink<T> = static_cast<T>(flags[COUNT / 2]);
+    });
+
+    run(name + "/operator!=", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        flags[i] = a[i] != b[i];
+      }
+
+      g_sink<T> = static_cast<T>(flags[COUNT / 2]);
+    });
+
+    binary("-vec", [](V x, V, T) { return -x; });
+
+    binary("vec+vec", [](V x, V y, T) { return x + y; });
+    binary("vec+scalar", [](V x, V, T k) { return x + k; });
+    binary("scalar+vec", [](V, V y, T k) { return k + y; });
+    compound("vec+=vec", [](V& x, V y, T) { x += y; });
+    compound("vec+=scalar", [](V& x, V, T k) { x += k; });
+
+    binary("vec-vec", [](V x, V y, T) { return x - y; });
+    binary("vec-scalar", [](V x, V, T k) { return x - k; });
+    binary("scalar-vec", [](V, V y, T k) { return k - y; });
+    compound("vec-=vec", [](V& x, V y, T) { x -= y; });
+    compound("vec-=scalar", [](V& x, V, T k) { x -= k; });
+
+    binary("vec*vec", [](V x, V y, T) { return x * y; });
+    binary("vec*scalar", [](V x, V, T k) { return x * k; });
+    binary("scalar*vec", [](V, V y, T k) { return k * y; });
+    compound("vec*=vec", [](V& x, V y, T) { x *= y; });
+    compound("vec*=scalar", [](V& x, V, T k) { x *= k; });
+
+    binary("vec/vec", [](V x, V y, T) { return x / y; });
+    binary("vec/scalar", [](V x, V, T k) { return x / k; });
+    binary("scalar/vec", [](V, V y, T k) { return k / y; });
+    compound("vec/=vec", [](V& x, V y, T) { x /= y; });
+    compound("vec/=scalar", [](V& x, V, T k) { x /= k; });
+  }
+
+  template<typename T, typename U, std::size_t N>
+  void bench_vec_conversion() {
+    const std::vector<vec<U, N>> a = make_values<vec<U, N>>(make_vec<U, N>);
+    std::vector<vec<T, N>> out(COUNT);
+
+    run(type_name<T, N>() + "/from " + type_name<U, N>(), [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        out[i] = vec<T, N>(a[i]);
+      }
+
+      g_sink<T> = out[COUNT / 2][0];
+    });
+  }
+
+  // matrices
+
+  template<typename T, std::size_t R, std::size_t C>
+  void bench_mat() {
+    using M = mat<T, R, C>;
+
+    const std::vector<M> a = make_values<M>(make_mat<T, R, C>);
+    const std::vector<M> b = make_values<M>([](std::size_t i) { return make_mat<T, R, C>(i + 1); });
+    const std::vector<mat<T, C, C>> square = make_values<mat<T, C, C>>(make_mat<T, C, C>);
+    const std::vector<vec<T, C>> columns = make_values<vec<T, C>>(make_vec<T, C>);
+    const std::vector<vec<T, R>> rows = make_values<vec<T, R>>(make_vec<T, R>);
+    const std::vector<T> s = make_values<T>(value<T>);
+    std::vector<M> out(COUNT);
+    std::vector<vec<T, R>> out_columns(COUNT);
+    std::vector<vec<T, C>> out_rows(COUNT);
+    std::vector<mat<T, C, R>> out_transposed(COUNT);
+    std::vector<char> flags(COUNT);
+
+    const std::string name = mat_name<T, R, C>();
+
+    auto binary = [&](const char *operation, auto function) {
+      run(name + "/" + operation, [&]() {
+        for (std::size_t i = 0; i < COUNT; ++i) {
+          out[i] = function(a[i], b[i], s[i]);
+        }
+
+        g_sink<T> = out[COUNT / 2](0, 0);
+      });
+    };
+
+    auto compound = [&](const char *operation, auto function) {
+      run(name + "/" + operation, [&]() {
+        for (std::size_t i = 0; i < COUNT; ++i) {
+          out[i] = a[i];
+          function(out[i], b[i], s[i]);
+        }
+
+        g_sink<T> = out[COUNT / 2](0, 0);
+      });
+    };
+
+    run(name + "/operator==", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        flags[i] = a[i] == b[i];
+      }
+
+      g_sink<T> = static_cast<T>(flags[COUNT / 2]);
+    });
+
+    run(name + "/operator!=", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        flags[i] = a[i] != b[i];
+      }
+
+      g_sink<T> = static_cast<T>(flags[COUNT / 2]);
+    });
+
+    binary("-mat", [](const M& x, const M&, T) { return -x; });
+
+    binary("mat+mat", [](const M& x, const M& y, T) { return x + y; });
+    compound("mat+=mat", [](M& x, const M& y, T) { x += y; });
+    binary("mat-mat", [](const M& x, const M& y, T) { return x - y; });
+    compound("mat-=mat", [](M& x, const M& y, T) { x -= y; });
+
+    binary("mat*scalar", [](const M& x, const M&, T k) { return x * k; });
+    binary("scalar*mat", [](const M&, const M& y, T k) { return k * y; });
+    compound("mat*=scalar", [](M& x, const M&, T k) { x *= k; });
+    binary("mat/scalar", [](const M& x, const M&, T k) { return x / k; });
+    binary("scalar/mat", [](const M&, const M& y, T k) { return k / y; });
+    compound("mat/=scalar", [](M& x, const M&, T k) { x /= k; });
+
+    run(name + "/mat*mat", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        out[i] = a[i] * square[i];
+      }
+
+      g_sink<T> = out[COUNT / 2](0, 0);
+    });
+
+    run(name + "/mat*=mat", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        out[i] = a[i];
+        out[i] *= square[i];
+      }
+
+      g_sink<T> = out[COUNT / 2](0, 0);
+    });
+
+    run(name + "/mat*vec", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        out_columns[i] = a[i] * columns[i];
+      }
+
+      g_sink<T> = out_columns[COUNT / 2][0];
+    });
+
+    run(name + "/vec*mat", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        out_rows[i] = rows[i] * a[i];
+      }
+
+      g_sink<T> = out_rows[COUNT / 2][0];
+    });
+
+    run(name + "/transpose", [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        out_transposed[i] = transpose(a[i]);
+      }
+
+      g_sink<T> = out_transposed[COUNT / 2](0, 0);
+    });
+
+    // the inverse of an integer matrix is not an integer matrix
+    if constexpr (R == C && !std::is_integral_v<T>) {
+      binary("invert", [](const M& x, const M&, T) { return invert(x); });
+    }
+  }
+
+  template<typename T, typename U, std::size_t R, std::size_t C>
+  void bench_mat_conversion() {
+    const std::vector<mat<U, R, C>> a = make_values<mat<U, R, C>>(make_mat<U, R, C>);
+    std::vector<mat<T, R, C>> out(COUNT);
+
+    run(mat_name<T, R, C>() + "/from " + mat_name<U, R, C>(), [&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        out[i] = mat<T, R, C>(a[i]);
+      }
+
+      g_sink<T> = out[COUNT / 2](0, 0);
+    });
+  }
+
+  template<typename T>
+  void bench_type() {
+    bench_vec<T, 2>();
+    bench_vec<T, 3>();
+    bench_vec<T, 4>();
+
+    bench_mat<T, 2, 2>();
+    bench_mat<T, 3, 3>();
+    bench_mat<T, 4, 4>();
+    bench_mat<T, 2, 3>();
+    bench_mat<T, 3, 4>();
+  }
+
+  template<std::size_t N>
+  void bench_conversions() {
+    bench_vec_conversion<float, double, N>();
+    bench_vec_conversion<float, int, N>();
+    bench_vec_conversion<double, float, N>();
+    bench_vec_conversion<int, float, N>();
+
+    bench_mat_conversion<float, double, N, N>();
+    bench_mat_conversion<float, int, N, N>();
+    bench_mat_conversion<double, float, N, N>();
+    bench_mat_conversion<int, float, N, N>();
+  }
+
+  const char *simd_name() {
+#if defined(HMI_SIMD_AVX)
+    return "AVX";
+#elif defined(HMI_SIMD_SSE2)
+    return "SSE2";
+#elif defined(HMI_SIMD_NEON)
+    return "NEON";
+#else
+    return "none";
+#endif
+  }
+
+  const char *compiler_name() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc";
+#else
+    return "unknown";
+#endif
+  }
+
+  // the path of the executable may contain backslashes
+  std::string escape(const char *text) {
+    std::string result;
+
+    for (; *text != '\0'; ++text) {
+      if (*text == '"' || *text == '\\') {
+        result += '\\';
+      }
+
+      result += *text;
+    }
+
+    return result;
+  }
+
+  void print_json(const char *executable) {
+    std::printf("{\n");
+    std::printf("  \"context\": {\n");
+    std::printf("    \"executable\": \"%s\",\n", escape(executable).c_str());
+    std::printf("    \"compiler\": \"%s\",\n", compiler_name());
+    std::printf("    \"simd\": \"%s\",\n", simd_name());
+#if defined(NDEBUG)
+    std::printf("    \"library_build_type\": \"release\"\n");
+#else
+    std::printf("    \"library_build_type\": \"debug\"\n");
+#endif
+    std::printf("  },\n");
+    std::printf("  \"benchmarks\": [\n");
+
+    for (std::size_t i = 0; i < g_results.size(); ++i) {
+      const result& current = g_results[i];
+      std::printf("    {\n");
+      std::printf("      \"name\": \"%s\",\n", current.name.c_str());
+      std::printf("      \"run_name\": \"%s\",\n", current.name.c_str());
+      std::printf("      \"run_type\": \"iteration\",\n");
+      std::printf("      \"repetitions\": %d,\n", REPETITIONS);
+      std::printf("      \"iterations\": %zu,\n", current.iterations);
+      std::printf("      \"real_time\": %.4f,\n", current.real_time);
+      std::printf("      \"cpu_time\": %.4f,\n", current.cpu_time);
+      std::printf("      \"time_unit\": \"ns\"\n");
+      std::printf("    }%s\n", i + 1 < g_results.size() ? "," : "");
+    }
+
+    std::printf("  ]\n");
+    std::printf("}\n");
+  }
+
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) {
+    g_filter = argv[1];
+  }
+
+  bench_type<float>();
+  bench_type<double>();
+  bench_type<int>();
+
+  bench_conversions<2>();
+  bench_conversions<3>();
+  bench_conversions<4>();
+
+  print_json(argv[0]);
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// the cost of including the headers: the compiler only parses the
+// translation units (-fsyntax-only or /Zs), the time is the median of a few
+// runs, and the empty translation unit gives the cost of starting the compiler
+
+namespace {
+
+  constexpr int ROUNDS = 7;
+
+  struct translation_unit {
+    const char *name;
+    const char *source;
+  };
+
+  const translation_unit TRANSLATION_UNITS[] = {
+    { "empty", "" },
+    { "<geometry_fwd>", "#include <geometry_fwd>\n" },
+    { "bits/vec.h", "#include <bits/vec.h>\n" },
+    { "bits/mat.h", "#include <bits/mat.h>\n" },
+    { "bits/renderer.h", "#include <bits/renderer.h>\n" },
+    { "<window>", "#include <window>\n" },
+    { "<geometry>", "#include <geometry>\n" },
+    // a typical user of the geometry, with the proxies of all the types instantiated
+    { "<geometry> + uses",
+      "#include <geometry>\n"
+      "float f(hmi::vec2f a, hmi::vec3f b, hmi::vec4f c, hmi::mat3f m, hmi::mat4f n) {\n"
+      "  return a.x + a.y + b.x + b.y + b.z + c.x + c.y + c.z + c.w + m.xx + m.zz + n.xx + n.ww;\n"
+      "}\n"
+    },
+  };
+
+  std::string command(const std::filesystem::path& file) {
+    std::string result = "\"" HMI_CXX_COMPILER "\"";
+#ifdef _MSC_VER
+    result += " /nologo /std:c++17 /Zs /I\"" HMI_INCLUDE_DIR "\" \"" + file.string() + "\"";
+#else
+    result += " -std=c++17 -fsyntax-only -I\"" HMI_INCLUDE_DIR "\" \"" + file.string() + "\"";
+#endif
+    return result;
+  }
+
+  double measure(const std::string& command) {
+    std::vector<double> times;
+
+    for (int round = 0; round < ROUNDS; ++round) {
+      auto start = std::chrono::steady_clock::now();
+
+      if (std::system(command.c_str()) != 0) {
+        return -1.0;
+      }
+
+      auto end = std::chrono::steady_clock::now();
+      times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+  }
+
+}
+
+int main() {
+  const std::filesystem::path directory = std::filesystem::temp_directory_path();
+
+  std::printf("compiler: %s\n", HMI_CXX_COMPILER);
+
+  for (const translation_unit& unit : TRANSLATION_UNITS) {
+    const std::filesystem::path file = directory / "hmi_bench_includes.cc";
+
+    {
+      std::ofstream output(file);
+      output << unit.source;
+    }
+
+    double time = measure(command(file));
+
+    if (time < 0.0) {
+      std::fprintf(stderr, "  %-20s failed to compile\n", unit.name);
+      continue;
+    }
+
+    std::printf("  %-20s %8.1f ms\n", unit.name, time);
+  }
+
+  std::filesystem::remove(directory / "hmi_bench_includes.cc");
+}
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <geometry>
+
+namespace {
+
+  constexpr std::size_t COUNT = 1 << 16;
+  constexpr int ROUNDS = 200;
+
+  volatile float g_sink = 0.0f;
+
+  template<typename Function>
+  double measure(Function function) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < ROUNDS; ++round) {
+      function();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double(ROUNDS) * COUNT);
+  }
+
+  double max_error(const std::vector<float>& angles, const std::vector<float>& sines, const std::vector<float>& cosines) {
+    double result = 0.0;
+
+    for (std::size_t i = 0; i < angles.size(); ++i) {
+      result = std::max(result, std::abs(sines[i] - std::sin(static_cast<double>(angles[i]))));
+      result = std::max(result, std::abs(cosines[i] - std::cos(static_cast<double>(angles[i]))));
+    }
+
+    return result;
+  }
+
+}
+
+int main() {
+  std::vector<float> angles(COUNT);
+  std::vector<float> sines(COUNT);
+  std::vector<float> cosines(COUNT);
+
+  // the angles of the renderer are in [0, 2 pi], the rest checks the range reduction
+  for (float range : { 6.2831853f, 100.0f, 8192.0f }) {
+    for (std::size_t i = 0; i < COUNT; ++i) {
+      angles[i] = range * (2.0f * i / (COUNT - 1) - 1.0f);
+    }
+
+    std::printf("angles in [-%g, %g]\n", range, range);
+
+    double libm = measure([&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        sines[i] = std::sin(angles[i]);
+        cosines[i] = std::cos(angles[i]);
+      }
+
+      g_sink = sines[COUNT / 2] + cosines[COUNT / 2];
+    });
+
+    std::printf("  std::sin + std::cos   %6.2f ns/angle   max error %.3g\n", libm, max_error(angles, sines, cosines));
+
+    double scalar = measure([&]() {
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        hmi::fast_sincos(angles[i], sines[i], cosines[i]);
+      }
+
+      g_sink = sines[COUNT / 2] + cosines[COUNT / 2];
+    });
+
+    std::printf("  fast_sincos (scalar)  %6.2f ns/angle   max error %.3g\n", scalar, max_error(angles, sines, cosines));
+
+    double batch = measure([&]() {
+      hmi::fast_sincos(angles, sines, cosines);
+      g_sink = sines[COUNT / 2] + cosines[COUNT / 2];
+    });
+
+    std::printf("  fast_sincos (batch)   %6.2f ns/angle   max error %.3g\n", batch, max_error(angles, sines, cosines));
+  }
+}
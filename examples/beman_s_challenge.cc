@@ -35,7 +35,7 @@ int main() {
       } else if (auto pevent = std::get_if<hmi::window_events::mouse_button_pressed>(&event)) {
         hmi::vec2f cursor = renderer.get_coords_from_position(pevent->position);
 
-        if (position.x <= cursor.x && cursor.x <= position.x + size.width && position.y <= cursor.y && cursor.y <= position.y + size.height) {
+        if (hmi::contains(hmi::box2f::from_position_size(position, size), cursor)) {
           dragging = true;
           mouse_position = pevent->position;
         }
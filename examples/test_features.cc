@@ -1,6 +1,8 @@
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 #include <geometry>
 #include <window>
@@ -13,6 +15,26 @@ int main() {
 
   auto renderer = window.get_renderer();
 
+  std::vector<hmi::vec2f> trend(1000000);
+
+  for (std::size_t i = 0; i < trend.size(); ++i) {
+    float x = 2 * object_size + 3 * object_padding + 2 * object_size * i / trend.size();
+    trend[i] = { x, 1.5f * object_size + 2 * object_padding + 0.5f * object_size * std::sin(i * 0.0001f) * std::cos(i * 0.01f) };
+  }
+
+  const hmi::color4f palette[] = { hmi::color::blue, hmi::color::cyan, hmi::color::yellow, hmi::color::red };
+  hmi::heatmap heatmap({ 64, 64 }, palette);
+  std::vector<float> temperatures(64 * 64);
+
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      temperatures[y * 64 + x] = std::sin(x * 0.1f) * std::cos(y * 0.1f);
+    }
+  }
+
+  heatmap.set_range(-1.0f, 1.0f);
+  heatmap.update(temperatures);
+
   while (window.is_open()) {
 
     while (auto maybe_event = window.poll_event()) {
@@ -34,6 +56,10 @@ int main() {
 
     renderer.draw_circle({ 1.5 * object_size + 2 * object_padding, 1.5f * object_size + 2 * object_padding }, 0.5f * object_size, hmi::color::magenta);
 
+    renderer.draw_line_strip(trend, hmi::color::violet, 2.0f);
+
+    renderer.draw_heatmap(heatmap, { 2 * object_size + 3 * object_padding, object_padding }, { object_size, object_size });
+
     renderer.display();
   }
 
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <geometry>
+#include <window>
+
+namespace {
+
+  // synthetic I420 frames: moving color bars over a luma gradient
+
+  void generate_frame(hmi::vec2i size, int frame, std::vector<std::uint8_t>& y, std::vector<std::uint8_t>& u, std::vector<std::uint8_t>& v) {
+    static constexpr std::uint8_t bars[][2] = {
+      { 128, 128 }, { 16, 146 }, { 166, 16 }, { 54, 34 }, { 202, 222 }, { 90, 240 }, { 240, 110 }, { 128, 128 },
+    };
+
+    static constexpr int bar_count = sizeof bars / sizeof bars[0];
+
+    for (int row = 0; row < size.height; ++row) {
+      for (int col = 0; col < size.width; ++col) {
+        y[row * size.width + col] = static_cast<std::uint8_t>(16 + (col + frame) % size.width * 219 / size.width);
+      }
+    }
+
+    hmi::vec2i chroma_size = { (size.width + 1) / 2, (size.height + 1) / 2 };
+
+    for (int row = 0; row < chroma_size.height; ++row) {
+      for (int col = 0; col < chroma_size.width; ++col) {
+        int bar = ((col + frame) % chroma_size.width) * bar_count / chroma_size.width;
+        u[row * chroma_size.width + col] = bars[bar][0];
+        v[row * chroma_size.width + col] = bars[bar][1];
+      }
+    }
+  }
+
+}
+
+int main() {
+  constexpr hmi::vec2i video_size = { 640, 360 };
+
+  hmi::window window("Video surface", { 1024, 576 });
+
+  auto renderer = window.get_renderer();
+
+  hmi::video_surface surface(video_size, hmi::video_format::i420);
+
+  std::atomic<bool> running(true);
+
+  std::thread producer([&]() {
+    hmi::vec2i chroma_size = surface.get_chroma_size();
+    std::vector<std::uint8_t> y(video_size.width * video_size.height);
+    std::vector<std::uint8_t> u(chroma_size.width * chroma_size.height);
+    std::vector<std::uint8_t> v(chroma_size.width * chroma_size.height);
+
+    for (int frame = 0; running; ++frame) {
+      generate_frame(video_size, frame, y, u, v);
+      surface.submit(y, u, v);
+      std::this_thread::sleep_for(std::chrono::milliseconds(33));
+    }
+  });
+
+  while (window.is_open()) {
+
+    while (auto maybe_event = window.poll_event()) {
+      auto& event = maybe_event.value();
+
+      if (std::get_if<hmi::window_events::closed>(&event)) {
+        window.close();
+      }
+
+    }
+
+    renderer.clear(hmi::color::black);
+
+    hmi::vec2f size = video_size;
+    renderer.draw_video(surface, (renderer.get_view_size() - size) / 2.0f, size);
+
+    renderer.display();
+  }
+
+  running = false;
+  producer.join();
+
+  return 0;
+}
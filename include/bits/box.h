@@ -0,0 +1,183 @@
+#ifndef HMI_BITS_BOX_H
+#define HMI_BITS_BOX_H
+
+#include <cstddef>
+#include <vector>
+
+#include "span.h"
+#include "vec.h"
+
+namespace hmi {
+
+  // axis-aligned box, the bounds are included and min <= max on every axis
+
+  template<typename T, std::size_t N>
+  struct box {
+    vec<T, N> min;
+    vec<T, N> max;
+
+    box() = default;
+
+    constexpr box(vec<T, N> lower, vec<T, N> upper) noexcept
+    : min(lower)
+    , max(upper)
+    {
+
+    }
+
+    // the box of the given position and size, the size may be negative
+    static constexpr box from_position_size(vec<T, N> position, vec<T, N> size) noexcept {
+      box result(position, position);
+
+      for (std::size_t i = 0; i < N; ++i) {
+        if (size[i] < T(0)) {
+          result.min[i] += size[i];
+        } else {
+          result.max[i] += size[i];
+        }
+      }
+
+      return result;
+    }
+
+    constexpr vec<T, N> size() const noexcept {
+      vec<T, N> result{};
+
+      for (std::size_t i = 0; i < N; ++i) {
+        result[i] = max[i] - min[i];
+      }
+
+      return result;
+    }
+  };
+
+  static_assert(detail::is_packed_v<box2f, float, 4>);
+
+  template<typename T, std::size_t N>
+  constexpr
+  bool operator==(const box<T, N>& lhs, const box<T, N>& rhs) noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      if (lhs.min[i] != rhs.min[i] || lhs.max[i] != rhs.max[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  bool operator!=(const box<T, N>& lhs, const box<T, N>& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  bool contains(const box<T, N>& b, vec<T, N> point) noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      if (point[i] < b.min[i] || b.max[i] < point[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  bool contains(const box<T, N>& b, const box<T, N>& other) noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      if (other.min[i] < b.min[i] || b.max[i] < other.max[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  bool intersects(const box<T, N>& lhs, const box<T, N>& rhs) noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      if (rhs.max[i] < lhs.min[i] || lhs.max[i] < rhs.min[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // smallest box containing both arguments
+
+  template<typename T, std::size_t N>
+  constexpr
+  box<T, N> merge(const box<T, N>& lhs, const box<T, N>& rhs) noexcept {
+    box<T, N> result = lhs;
+
+    for (std::size_t i = 0; i < N; ++i) {
+      result.min[i] = rhs.min[i] < result.min[i] ? rhs.min[i] : result.min[i];
+      result.max[i] = result.max[i] < rhs.max[i] ? rhs.max[i] : result.max[i];
+    }
+
+    return result;
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  box<T, N> merge(const box<T, N>& b, vec<T, N> point) noexcept {
+    return merge(b, box<T, N>(point, point));
+  }
+
+  // nearest point of the box
+
+  template<typename T, std::size_t N>
+  constexpr
+  vec<T, N> clamp(const box<T, N>& b, vec<T, N> point) noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      if (point[i] < b.min[i]) {
+        point[i] = b.min[i];
+      } else if (b.max[i] < point[i]) {
+        point[i] = b.max[i];
+      }
+    }
+
+    return point;
+  }
+
+  // the margin is added on both sides, a negative margin shrinks the box
+
+  template<typename T, std::size_t N>
+  constexpr
+  box<T, N> expand(const box<T, N>& b, vec<T, N> margin) noexcept {
+    box<T, N> result = b;
+
+    for (std::size_t i = 0; i < N; ++i) {
+      result.min[i] -= margin[i];
+      result.max[i] += margin[i];
+    }
+
+    return result;
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  box<T, N> expand(const box<T, N>& b, T margin) noexcept {
+    box<T, N> result = b;
+
+    for (std::size_t i = 0; i < N; ++i) {
+      result.min[i] -= margin;
+      result.max[i] += margin;
+    }
+
+    return result;
+  }
+
+  // bulk queries, the indices of the matching boxes are appended to the result
+
+  void find_containing(span<const box2f> boxes, vec2f point, std::vector<std::size_t>& result);
+
+  void find_intersecting(span<const box2f> boxes, const box2f& query, std::vector<std::size_t>& result);
+
+}
+
+#endif // HMI_BITS_BOX_H
@@ -1,6 +1,10 @@
 #ifndef HMI_BITS_COLOR_H
 #define HMI_BITS_COLOR_H
 
+#include <cstdint>
+
+#include "half.h"
+#include "span.h"
 #include "vec.h"
 
 namespace hmi {
@@ -27,7 +31,107 @@ namespace hmi {
 
   }
 
-}
+  static_assert(detail::is_packed_v<color4u8, std::uint8_t, 4>);
+
+  // the components of color4u8 are in [0, 255], the components of color4f
+  // are clamped to [0, 1] and rounded to the nearest integer
+
+  constexpr color4f to_color4f(color4u8 c) noexcept {
+    color4f result{};
+
+    for (std::size_t i = 0; i < 4; ++i) {
+      result[i] = static_cast<float>(c[i]) / 255.0f;
+    }
+
+    return result;
+  }
+
+  constexpr color4u8 to_color4u8(color4f c) noexcept {
+    color4u8 result{};
+
+    for (std::size_t i = 0; i < 4; ++i) {
+      float value = c[i] > 0.0f ? c[i] : 0.0f; // NaN gives 0
+      value = value < 1.0f ? value : 1.0f;
+      result[i] = static_cast<std::uint8_t>(value * 255.0f + 0.5f);
+    }
+
+    return result;
+  }
 
+  // premultiplied alpha: the color components are multiplied by alpha
+
+  constexpr color4f premultiply(color4f c) noexcept {
+    return color4f(c[0] * c[3], c[1] * c[3], c[2] * c[3], c[3]);
+  }
+
+  constexpr color4f unpremultiply(color4f c) noexcept {
+    if (c[3] == 0.0f) {
+      return color4f(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    return color4f(c[0] / c[3], c[1] / c[3], c[2] / c[3], c[3]);
+  }
+
+  namespace detail {
+
+    // x * a / 255 rounded to the nearest integer, without a division
+    constexpr std::uint8_t mul_u8(unsigned x, unsigned a) noexcept {
+      unsigned t = x * a + 128;
+      return static_cast<std::uint8_t>((t + (t >> 8)) >> 8);
+    }
+
+  }
+
+  constexpr color4u8 premultiply(color4u8 c) noexcept {
+    return color4u8(detail::mul_u8(c[0], c[3]), detail::mul_u8(c[1], c[3]), detail::mul_u8(c[2], c[3]), c[3]);
+  }
+
+  constexpr color4u8 unpremultiply(color4u8 c) noexcept {
+    color4u8 result{};
+    result[3] = c[3];
+
+    if (c[3] == 0) {
+      return result;
+    }
+
+    for (std::size_t i = 0; i < 3; ++i) {
+      unsigned value = (c[i] * 255u + c[3] / 2u) / c[3];
+      result[i] = static_cast<std::uint8_t>(value < 255u ? value : 255u);
+    }
+
+    return result;
+  }
+
+  // sRGB transfer functions, the alpha component is left unchanged; the
+  // float versions are exact, the others go through lookup tables: 256
+  // entries from color4u8 and 4096 entries to color4u8 (at most 1 off)
+
+  float to_linear(float srgb) noexcept;
+
+  float to_srgb(float linear) noexcept;
+
+  color4f to_linear(color4f srgb) noexcept;
+
+  color4f to_srgb(color4f linear) noexcept;
+
+  color4f to_linear(color4u8 srgb) noexcept;
+
+  color4u8 to_srgb8(color4f linear) noexcept;
+
+  // bulk conversions, premultiplication and sRGB transfer, with SSE2 or NEON
+
+  void convert(span<const color4u8> in, span<color4f> out);
+
+  void convert(span<const color4f> in, span<color4u8> out);
+
+  void premultiply(span<color4f> colors);
+
+  void premultiply(span<color4u8> colors);
+
+  void to_linear(span<const color4u8> in, span<color4f> out);
+
+  void to_srgb(span<const color4f> in, span<color4u8> out);
+
+}
 
 #endif // HMI_BITS_COLOR_H
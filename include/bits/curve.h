@@ -0,0 +1,115 @@
+#ifndef HMI_BITS_CURVE_H
+#define HMI_BITS_CURVE_H
+
+#include <cstddef>
+
+#include "span.h"
+#include "vec.h"
+#include "vec_ops.h"
+
+namespace hmi {
+
+  // cubic Bézier curve, p0 and p3 are the ends and p1 and p2 the control points
+
+  template<typename T, std::size_t N>
+  struct cubic_bezier {
+    vec<T, N> p0;
+    vec<T, N> p1;
+    vec<T, N> p2;
+    vec<T, N> p3;
+
+    cubic_bezier() = default;
+
+    constexpr cubic_bezier(vec<T, N> start, vec<T, N> control1, vec<T, N> control2, vec<T, N> end) noexcept
+    : p0(start)
+    , p1(control1)
+    , p2(control2)
+    , p3(end)
+    {
+
+    }
+
+    // the tangents are the derivatives at the ends
+    static constexpr cubic_bezier from_hermite(vec<T, N> start, vec<T, N> start_tangent, vec<T, N> end, vec<T, N> end_tangent) noexcept {
+      return cubic_bezier(start, start + start_tangent / T(3), end - end_tangent / T(3), end);
+    }
+
+    // the segment between p1 and p2 of a uniform Catmull-Rom spline
+    static constexpr cubic_bezier from_catmull_rom(vec<T, N> p0, vec<T, N> p1, vec<T, N> p2, vec<T, N> p3) noexcept {
+      return cubic_bezier(p1, p1 + (p2 - p0) / T(6), p2 - (p3 - p1) / T(6), p2);
+    }
+  };
+
+  static_assert(detail::is_packed_v<cubic_bezier2f, float, 8>);
+
+  // Bernstein form, t in [0, 1]
+
+  template<typename T, std::size_t N>
+  constexpr
+  vec<T, N> evaluate(const cubic_bezier<T, N>& curve, T t) noexcept {
+    T u = T(1) - t;
+    T uu = u * u;
+    T tt = t * t;
+    return curve.p0 * (uu * u) + curve.p1 * (T(3) * uu * t) + curve.p2 * (T(3) * u * tt) + curve.p3 * (tt * t);
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  vec<T, N> hermite(vec<T, N> start, vec<T, N> start_tangent, vec<T, N> end, vec<T, N> end_tangent, T t) noexcept {
+    return evaluate(cubic_bezier<T, N>::from_hermite(start, start_tangent, end, end_tangent), t);
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  vec<T, N> catmull_rom(vec<T, N> p0, vec<T, N> p1, vec<T, N> p2, vec<T, N> p3, T t) noexcept {
+    return evaluate(cubic_bezier<T, N>::from_catmull_rom(p0, p1, p2, p3), t);
+  }
+
+  // points.size() points at t = i / (points.size() - 1), with forward
+  // differences: three additions per point instead of a polynomial
+
+  template<typename T, std::size_t N>
+  void sample(const cubic_bezier<T, N>& curve, span<vec<T, N>> points) {
+    const std::size_t count = points.size();
+
+    if (count == 0) {
+      return;
+    }
+
+    if (count == 1) {
+      points[0] = curve.p0;
+      return;
+    }
+
+    const vec<T, N> a = curve.p3 - curve.p0 + (curve.p1 - curve.p2) * T(3);
+    const vec<T, N> b = (curve.p2 - curve.p1 * T(2) + curve.p0) * T(3);
+    const vec<T, N> c = (curve.p1 - curve.p0) * T(3);
+
+    const T h = T(1) / static_cast<T>(count - 1);
+    const T h2 = h * h;
+    const T h3 = h2 * h;
+
+    vec<T, N> f = curve.p0;
+    vec<T, N> df = a * h3 + b * h2 + c * h;
+    vec<T, N> ddf = a * (T(6) * h3) + b * (T(2) * h2);
+    const vec<T, N> dddf = a * (T(6) * h3);
+
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+      points[i] = f;
+      f += df;
+      df += ddf;
+      ddf += dddf;
+    }
+
+    // the sums drift, the end is exact
+    points[count - 1] = curve.p3;
+  }
+
+  // one point per curve, 4 curves at a time with SSE2 or NEON; the results
+  // are the same as the scalar evaluate
+
+  void evaluate(span<const cubic_bezier2f> curves, span<const float> t, span<vec2f> points);
+
+}
+
+#endif // HMI_BITS_CURVE_H
@@ -0,0 +1,362 @@
+#ifndef HMI_BITS_FIXED_H
+#define HMI_BITS_FIXED_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include "vec.h"
+
+namespace hmi {
+
+  namespace detail {
+
+    template<int Bits>
+    using fixed_storage_t = std::conditional_t<(Bits <= 8), std::int8_t, std::conditional_t<(Bits <= 16), std::int16_t, std::int32_t>>;
+
+    // large enough for the product of two raw values
+    template<int Bits>
+    using fixed_wide_t = std::conditional_t<(Bits <= 16), std::int32_t, std::int64_t>;
+
+  }
+
+  // a signed fixed-point number with IntBits bits for the integer part (sign
+  // included) and FracBits bits for the fractional part; the operations
+  // round to nearest and saturate instead of overflowing
+
+  template<int IntBits, int FracBits>
+  struct fixed {
+    static_assert(IntBits >= 1 && FracBits >= 0 && IntBits + FracBits <= 32, "fixed should fit in 32 bits");
+
+    using storage_type = detail::fixed_storage_t<IntBits + FracBits>;
+    using wide_type = detail::fixed_wide_t<IntBits + FracBits>;
+
+    static constexpr wide_type ONE = wide_type(1) << FracBits;
+    static constexpr wide_type RAW_MAX = (wide_type(1) << (IntBits + FracBits - 1)) - 1;
+    static constexpr wide_type RAW_MIN = - RAW_MAX - 1;
+
+    storage_type raw;
+
+    fixed() = default;
+
+    // integers are exact (or saturated), so the conversion is implicit
+    template<typename I, std::enable_if_t<std::is_integral_v<I>, int> = 0>
+    constexpr fixed(I value) noexcept
+    : raw(from_integer(value))
+    {
+
+    }
+
+    template<typename F, std::enable_if_t<std::is_floating_point_v<F>, int> = 0>
+    explicit constexpr fixed(F value) noexcept
+    : raw(from_floating(value))
+    {
+
+    }
+
+    template<int OtherIntBits, int OtherFracBits>
+    explicit constexpr fixed(fixed<OtherIntBits, OtherFracBits> other) noexcept
+    : raw(0)
+    {
+      std::int64_t value = other.raw;
+
+      if constexpr (OtherFracBits > FracBits) {
+        value = (value + (std::int64_t(1) << (OtherFracBits - FracBits - 1))) >> (OtherFracBits - FracBits);
+      } else {
+        value *= std::int64_t(1) << (FracBits - OtherFracBits);
+      }
+
+      raw = saturate(value);
+    }
+
+    template<typename F, std::enable_if_t<std::is_floating_point_v<F>, int> = 0>
+    explicit constexpr operator F() const noexcept {
+      return static_cast<F>(raw) / static_cast<F>(ONE);
+    }
+
+    // truncated toward zero, like a float
+    template<typename I, std::enable_if_t<std::is_integral_v<I> && !std::is_same_v<I, bool>, int> = 0>
+    explicit constexpr operator I() const noexcept {
+      return static_cast<I>(raw / ONE);
+    }
+
+    static constexpr fixed from_raw(wide_type raw) noexcept {
+      fixed result{};
+      result.raw = saturate(raw);
+      return result;
+    }
+
+    static constexpr fixed max() noexcept {
+      return from_raw(RAW_MAX);
+    }
+
+    static constexpr fixed lowest() noexcept {
+      return from_raw(RAW_MIN);
+    }
+
+    static constexpr fixed epsilon() noexcept {
+      return from_raw(1);
+    }
+
+    constexpr fixed operator+() const noexcept {
+      return *this;
+    }
+
+    constexpr fixed operator-() const noexcept {
+      return from_raw(- wide_type(raw));
+    }
+
+    constexpr fixed& operator+=(fixed other) noexcept {
+      return *this = *this + other;
+    }
+
+    constexpr fixed& operator-=(fixed other) noexcept {
+      return *this = *this - other;
+    }
+
+    constexpr fixed& operator*=(fixed other) noexcept {
+      return *this = *this * other;
+    }
+
+    constexpr fixed& operator/=(fixed other) noexcept {
+      return *this = *this / other;
+    }
+
+    // the operators are hidden friends so that integers are converted
+
+    friend constexpr fixed operator+(fixed lhs, fixed rhs) noexcept {
+      return from_raw(wide_type(lhs.raw) + rhs.raw);
+    }
+
+    friend constexpr fixed operator-(fixed lhs, fixed rhs) noexcept {
+      return from_raw(wide_type(lhs.raw) - rhs.raw);
+    }
+
+    friend constexpr fixed operator*(fixed lhs, fixed rhs) noexcept {
+      wide_type product = wide_type(lhs.raw) * rhs.raw;
+
+      if constexpr (FracBits > 0) {
+        product = (product + (wide_type(1) << (FracBits - 1))) >> FracBits;
+      }
+
+      return from_raw(product);
+    }
+
+    // a division by zero gives the bound with the sign of the dividend
+    friend constexpr fixed operator/(fixed lhs, fixed rhs) noexcept {
+      if (rhs.raw == 0) {
+        return lhs.raw > 0 ? max() : (lhs.raw < 0 ? lowest() : fixed(0));
+      }
+
+      wide_type dividend = wide_type(lhs.raw) * ONE;
+      wide_type divisor = rhs.raw;
+
+      // rounded half away from zero
+      if ((dividend < 0) == (divisor < 0)) {
+        dividend += divisor / 2;
+      } else {
+        dividend -= divisor / 2;
+      }
+
+      return from_raw(dividend / divisor);
+    }
+
+    friend constexpr bool operator==(fixed lhs, fixed rhs) noexcept {
+      return lhs.raw == rhs.raw;
+    }
+
+    friend constexpr bool operator!=(fixed lhs, fixed rhs) noexcept {
+      return lhs.raw != rhs.raw;
+    }
+
+    friend constexpr bool operator<(fixed lhs, fixed rhs) noexcept {
+      return lhs.raw < rhs.raw;
+    }
+
+    friend constexpr bool operator<=(fixed lhs, fixed rhs) noexcept {
+      return lhs.raw <= rhs.raw;
+    }
+
+    friend constexpr bool operator>(fixed lhs, fixed rhs) noexcept {
+      return lhs.raw > rhs.raw;
+    }
+
+    friend constexpr bool operator>=(fixed lhs, fixed rhs) noexcept {
+      return lhs.raw >= rhs.raw;
+    }
+
+  private:
+    static constexpr storage_type saturate(std::int64_t value) noexcept {
+      return static_cast<storage_type>(value < RAW_MIN ? RAW_MIN : (value > RAW_MAX ? RAW_MAX : value));
+    }
+
+    template<typename I>
+    static constexpr storage_type from_integer(I value) noexcept {
+      constexpr wide_type INT_MAX_VALUE = RAW_MAX / ONE;
+
+      if constexpr (std::is_signed_v<I>) {
+        constexpr wide_type INT_MIN_VALUE = - INT_MAX_VALUE - 1;
+
+        if (static_cast<long long>(value) < INT_MIN_VALUE) {
+          return static_cast<storage_type>(RAW_MIN);
+        }
+
+        if (static_cast<long long>(value) > INT_MAX_VALUE) {
+          return static_cast<storage_type>(RAW_MAX);
+        }
+      } else {
+        if (static_cast<unsigned long long>(value) > static_cast<unsigned long long>(INT_MAX_VALUE)) {
+          return static_cast<storage_type>(RAW_MAX);
+        }
+      }
+
+      return static_cast<storage_type>(static_cast<wide_type>(value) * ONE);
+    }
+
+    template<typename F>
+    static constexpr storage_type from_floating(F value) noexcept {
+      F scaled = value * static_cast<F>(ONE);
+
+      if (scaled != scaled) { // NaN
+        return 0;
+      }
+
+      if (scaled >= static_cast<F>(RAW_MAX)) {
+        return static_cast<storage_type>(RAW_MAX);
+      }
+
+      if (scaled <= static_cast<F>(RAW_MIN)) {
+        return static_cast<storage_type>(RAW_MIN);
+      }
+
+      return static_cast<storage_type>(static_cast<wide_type>(scaled < 0 ? scaled - F(0.5) : scaled + F(0.5)));
+    }
+  };
+
+  // mixed operations with floating-point numbers are done in floating point
+
+  template<int I, int F, typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+  constexpr T operator+(fixed<I, F> lhs, T rhs) noexcept {
+    return static_cast<T>(lhs) + rhs;
+  }
+
+  template<int I, int F, typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+  constexpr T operator+(T lhs, fixed<I, F> rhs) noexcept {
+    return lhs + static_cast<T>(rhs);
+  }
+
+  template<int I, int F, typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+  constexpr T operator-(fixed<I, F> lhs, T rhs) noexcept {
+    return static_cast<T>(lhs) - rhs;
+  }
+
+  template<int I, int F, typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+  constexpr T operator-(T lhs, fixed<I, F> rhs) noexcept {
+    return lhs - static_cast<T>(rhs);
+  }
+
+  template<int I, int F, typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+  constexpr T operator*(fixed<I, F> lhs, T rhs) noexcept {
+    return static_cast<T>(lhs) * rhs;
+  }
+
+  template<int I, int F, typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+  constexpr T operator*(T lhs, fixed<I, F> rhs) noexcept {
+    return lhs * static_cast<T>(rhs);
+  }
+
+  template<int I, int F, typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+  constexpr T operator/(fixed<I, F> lhs, T rhs) noexcept {
+    return static_cast<T>(lhs) / rhs;
+  }
+
+  template<int I, int F, typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+  constexpr T operator/(T lhs, fixed<I, F> rhs) noexcept {
+    return lhs / static_cast<T>(rhs);
+  }
+
+  // rounding to an integral value
+
+  template<int I, int F>
+  constexpr fixed<I, F> floor(fixed<I, F> x) noexcept {
+    using wide_type = typename fixed<I, F>::wide_type;
+    wide_type remainder = x.raw % fixed<I, F>::ONE;
+
+    if (remainder < 0) {
+      remainder += fixed<I, F>::ONE;
+    }
+
+    return fixed<I, F>::from_raw(wide_type(x.raw) - remainder);
+  }
+
+  template<int I, int F>
+  constexpr fixed<I, F> ceil(fixed<I, F> x) noexcept {
+    using wide_type = typename fixed<I, F>::wide_type;
+    wide_type remainder = x.raw % fixed<I, F>::ONE;
+
+    if (remainder > 0) {
+      remainder -= fixed<I, F>::ONE;
+    }
+
+    return fixed<I, F>::from_raw(wide_type(x.raw) - remainder);
+  }
+
+  // halfway cases are rounded away from zero, like std::round
+  template<int I, int F>
+  constexpr fixed<I, F> round(fixed<I, F> x) noexcept {
+    using wide_type = typename fixed<I, F>::wide_type;
+    const wide_type half = fixed<I, F>::ONE / 2;
+
+    if (x.raw < 0) {
+      return - floor(fixed<I, F>::from_raw(half - wide_type(x.raw)));
+    }
+
+    return floor(fixed<I, F>::from_raw(wide_type(x.raw) + half));
+  }
+
+  template<int I, int F>
+  constexpr fixed<I, F> abs(fixed<I, F> x) noexcept {
+    return x.raw < 0 ? -x : x;
+  }
+
+  static_assert(detail::is_packed_v<fixed16_16, std::int32_t, 1> && detail::is_packed_v<vec2x, std::int32_t, 2>);
+
+  namespace detail {
+
+    template<typename Fixed, typename T, bool = std::is_arithmetic_v<T>>
+    struct fixed_common_type {
+    };
+
+    template<typename Fixed, typename T>
+    struct fixed_common_type<Fixed, T, true> {
+      using type = std::conditional_t<std::is_floating_point_v<T>, T, Fixed>;
+    };
+
+  }
+
+}
+
+namespace std {
+
+  // fixed with an integer gives fixed, fixed with a floating-point type
+  // gives the floating-point type, two different formats have no common type
+
+  template<int I, int F, typename T>
+  struct common_type<hmi::fixed<I, F>, T> : hmi::detail::fixed_common_type<hmi::fixed<I, F>, T> {
+  };
+
+  template<int I, int F, typename T>
+  struct common_type<T, hmi::fixed<I, F>> : hmi::detail::fixed_common_type<hmi::fixed<I, F>, T> {
+  };
+
+  template<int I1, int F1, int I2, int F2>
+  struct common_type<hmi::fixed<I1, F1>, hmi::fixed<I2, F2>> {
+  };
+
+  template<int I, int F>
+  struct common_type<hmi::fixed<I, F>, hmi::fixed<I, F>> {
+    using type = hmi::fixed<I, F>;
+  };
+
+}
+
+#endif // HMI_BITS_FIXED_H
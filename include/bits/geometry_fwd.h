@@ -0,0 +1,211 @@
+#ifndef HMI_BITS_GEOMETRY_FWD_H
+#define HMI_BITS_GEOMETRY_FWD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// declarations of the types of <geometry> and of their aliases, enough for
+// the headers that only name them in declarations
+
+namespace hmi {
+
+  template<typename T, std::size_t N>
+  struct vec;
+
+  template<typename T, std::size_t R, std::size_t C = R>
+  struct mat;
+
+  template<typename T, std::size_t N>
+  struct aligned_vec;
+
+  template<typename T, std::size_t R, std::size_t C = R>
+  struct aligned_mat;
+
+  template<typename T, std::size_t N>
+  struct box;
+
+  template<int IntBits, int FracBits>
+  struct fixed;
+
+  struct half;
+
+  template<typename T>
+  struct quat;
+
+  template<typename T, std::size_t N>
+  struct cubic_bezier;
+
+  template<typename T, std::size_t N>
+  class vec_soa;
+
+  class prepared_polygon;
+
+
+  template<typename T>
+  using vec2 = vec<T, 2>;
+
+  using vec2f = vec2<float>;
+
+  using vec2d = vec2<double>;
+
+  using vec2i = vec2<int>;
+
+
+  template<typename T>
+  using vec3 = vec<T, 3>;
+
+  using vec3f = vec3<float>;
+
+  using vec3d = vec3<double>;
+
+  using vec3i = vec3<int>;
+
+
+  template<typename T>
+  using vec4 = vec<T, 4>;
+
+  using vec4f = vec4<float>;
+
+  using vec4d = vec4<double>;
+
+  using vec4i = vec4<int>;
+
+
+  using color3f = vec3f;
+
+  using color4f = vec4f;
+
+
+  using vec3f_a = aligned_vec<float, 3>;
+
+  using vec4f_a = aligned_vec<float, 4>;
+
+  using vec4i_a = aligned_vec<int, 4>;
+
+
+  template<typename T>
+  using mat2 = mat<T, 2>;
+
+  using mat2f = mat2<float>;
+
+  using mat2d = mat2<double>;
+
+  using mat2i = mat2<int>;
+
+  template<typename T>
+  using mat3 = mat<T, 3>;
+
+  using mat3f = mat3<float>;
+
+  using mat3d = mat3<double>;
+
+  using mat3i = mat3<int>;
+
+  template<typename T>
+  using mat4 = mat<T, 4>;
+
+  using mat4f = mat4<float>;
+
+  using mat4d = mat4<double>;
+
+  using mat4i = mat4<int>;
+
+  // non-square matrices are named after their rows and columns
+
+  template<typename T>
+  using mat2x3 = mat<T, 2, 3>;
+
+  using mat2x3f = mat2x3<float>;
+
+  using mat2x3d = mat2x3<double>;
+
+  using mat2x3i = mat2x3<int>;
+
+  template<typename T>
+  using mat3x4 = mat<T, 3, 4>;
+
+  using mat3x4f = mat3x4<float>;
+
+  using mat3x4d = mat3x4<double>;
+
+  using mat3x4i = mat3x4<int>;
+
+  using mat4f_a = aligned_mat<float, 4>;
+
+  using mat3x4f_a = aligned_mat<float, 3, 4>;
+
+
+  // 16.16 is the format of GL_FIXED
+  using fixed16_16 = fixed<16, 16>;
+
+  using fixed24_8 = fixed<24, 8>;
+
+  using fixed8_8 = fixed<8, 8>;
+
+  using vec2x = vec2<fixed16_16>;
+
+  using vec3x = vec3<fixed16_16>;
+
+  using vec4x = vec4<fixed16_16>;
+
+
+  using vec2h = vec2<half>;
+
+  using vec3h = vec3<half>;
+
+  using vec4h = vec4<half>;
+
+  // packed color types: 4 bytes and 8 bytes per color instead of 16
+
+  using color4u8 = vec4<std::uint8_t>;
+
+  using color4h = vec4h;
+
+
+  template<typename T>
+  using box2 = box<T, 2>;
+
+  using box2f = box2<float>;
+
+  using box2d = box2<double>;
+
+  using box2i = box2<int>;
+
+  template<typename T>
+  using box3 = box<T, 3>;
+
+  using box3f = box3<float>;
+
+  using box3d = box3<double>;
+
+  using box3i = box3<int>;
+
+
+  // 2D affine transformations, with the constant last row implied
+  template<typename T>
+  using transform2 = mat2x3<T>;
+
+  using transform2f = transform2<float>;
+
+  using transform2d = transform2<double>;
+
+
+  using quatf = quat<float>;
+
+  using quatd = quat<double>;
+
+
+  using cubic_bezier2f = cubic_bezier<float, 2>;
+
+  using cubic_bezier3f = cubic_bezier<float, 3>;
+
+
+  using vec2f_soa = vec_soa<float, 2>;
+
+  using vec3f_soa = vec_soa<float, 3>;
+
+  using vec4f_soa = vec_soa<float, 4>;
+
+}
+
+#endif // HMI_BITS_GEOMETRY_FWD_H
@@ -0,0 +1,159 @@
+#ifndef HMI_BITS_HALF_H
+#define HMI_BITS_HALF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "simd.h"
+#include "span.h"
+#include "vec.h"
+
+namespace hmi {
+
+  namespace detail {
+
+    // conversions between float and IEEE 754 binary16, rounded to nearest
+    // even; without F16C, NaNs lose their payload
+
+    inline std::uint16_t float_to_half(float value) noexcept {
+#if defined(HMI_SIMD_F16C)
+      return static_cast<std::uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+      constexpr std::uint32_t F32_INFINITY = 255u << 23;
+      constexpr std::uint32_t F16_OVERFLOW = (127u + 16u) << 23;
+      constexpr std::uint32_t F16_MIN_NORMAL = 113u << 23;
+      constexpr std::uint32_t DENORMAL_MAGIC = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+      std::uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+
+      const std::uint32_t sign = bits & 0x80000000u;
+      bits ^= sign;
+
+      std::uint32_t result;
+
+      if (bits >= F16_OVERFLOW) {
+        result = bits > F32_INFINITY ? 0x7E00u : 0x7C00u;
+      } else if (bits < F16_MIN_NORMAL) {
+        // the addition shifts the mantissa in place and rounds it
+        float magnitude, magic;
+        std::memcpy(&magnitude, &bits, sizeof(magnitude));
+        std::memcpy(&magic, &DENORMAL_MAGIC, sizeof(magic));
+        magnitude += magic;
+        std::memcpy(&result, &magnitude, sizeof(result));
+        result -= DENORMAL_MAGIC;
+      } else {
+        const std::uint32_t odd = (bits >> 13) & 1u;
+        bits += ((15u - 127u) << 23) + 0xFFFu + odd;
+        result = bits >> 13;
+      }
+
+      return static_cast<std::uint16_t>(result | (sign >> 16));
+#endif
+    }
+
+    inline float half_to_float(std::uint16_t value) noexcept {
+#if defined(HMI_SIMD_F16C)
+      return _cvtsh_ss(value);
+#else
+      constexpr std::uint32_t SHIFTED_EXPONENT = 0x7C00u << 13;
+      constexpr std::uint32_t DENORMAL_MAGIC = 113u << 23;
+
+      std::uint32_t bits = (value & 0x7FFFu) << 13;
+      const std::uint32_t exponent = bits & SHIFTED_EXPONENT;
+      bits += (127u - 15u) << 23;
+
+      if (exponent == SHIFTED_EXPONENT) {
+        // infinity or NaN
+        bits += (128u - 16u) << 23;
+      } else if (exponent == 0) {
+        // zero or denormal, renormalized by a subtraction
+        bits += 1u << 23;
+        float magnitude, magic;
+        std::memcpy(&magnitude, &bits, sizeof(magnitude));
+        std::memcpy(&magic, &DENORMAL_MAGIC, sizeof(magic));
+        magnitude -= magic;
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+      }
+
+      bits |= static_cast<std::uint32_t>(value & 0x8000u) << 16;
+
+      float result;
+      std::memcpy(&result, &bits, sizeof(result));
+      return result;
+#endif
+    }
+
+  }
+
+  // a 16-bit floating-point number, only meant for storage: the arithmetic
+  // is done on float through the implicit conversion
+
+  struct half {
+    std::uint16_t bits;
+
+    half() = default;
+
+    explicit half(float value) noexcept
+    : bits(detail::float_to_half(value))
+    {
+
+    }
+
+    operator float() const noexcept {
+      return detail::half_to_float(bits);
+    }
+
+    static constexpr half from_bits(std::uint16_t bits) noexcept {
+      half result{};
+      result.bits = bits;
+      return result;
+    }
+  };
+
+  static_assert(detail::is_packed_v<half, std::uint16_t, 1> && detail::is_packed_v<vec4h, half, 4>);
+
+  // bulk conversions, with F16C, SSE2 or NEON
+
+  void convert(span<const half> in, span<float> out);
+
+  void convert(span<const float> in, span<half> out);
+
+  namespace detail {
+
+    template<typename T, typename U, std::size_t N>
+    void convert_components(span<const vec<T, N>> in, span<vec<U, N>> out) {
+      static_assert(sizeof(vec<half, N>) == N * sizeof(half), "vec<half, N> should be made of N packed halfs");
+      convert(span<const T>(reinterpret_cast<const T *>(in.data()), in.size() * N), span<U>(reinterpret_cast<U *>(out.data()), out.size() * N));
+    }
+
+  }
+
+  inline void convert(span<const vec2h> in, span<vec2f> out) {
+    detail::convert_components(in, out);
+  }
+
+  inline void convert(span<const vec3h> in, span<vec3f> out) {
+    detail::convert_components(in, out);
+  }
+
+  inline void convert(span<const vec4h> in, span<vec4f> out) {
+    detail::convert_components(in, out);
+  }
+
+  inline void convert(span<const vec2f> in, span<vec2h> out) {
+    detail::convert_components(in, out);
+  }
+
+  inline void convert(span<const vec3f> in, span<vec3h> out) {
+    detail::convert_components(in, out);
+  }
+
+  inline void convert(span<const vec4f> in, span<vec4h> out) {
+    detail::convert_components(in, out);
+  }
+
+}
+
+#endif // HMI_BITS_HALF_H
@@ -0,0 +1,54 @@
+#ifndef HMI_BITS_HEATMAP_H
+#define HMI_BITS_HEATMAP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "span.h"
+#include "vec.h"
+
+namespace hmi {
+  class renderer;
+
+  class heatmap {
+  public:
+    heatmap(vec2i size, span<const color4f> palette);
+    ~heatmap();
+
+    heatmap(const heatmap&) = delete;
+    heatmap& operator=(const heatmap&) = delete;
+
+    vec2i get_size() const {
+      return m_size;
+    }
+
+    void set_palette(span<const color4f> palette);
+
+    void set_range(float min, float max) {
+      m_min = min;
+      m_max = max;
+    }
+
+    void update(span<const float> values);
+
+    void update(span<const std::uint16_t> values);
+
+  private:
+    void upload();
+
+  private:
+    friend class renderer;
+
+    vec2i m_size;
+    float m_min;
+    float m_max;
+
+    uint32_t m_values_texture;
+    uint32_t m_palette_texture;
+
+    std::vector<std::uint8_t> m_buffer;
+  };
+
+}
+
+#endif // HMI_BITS_HEATMAP_H
@@ -0,0 +1,486 @@
+#ifndef HMI_BITS_LAZY_H
+#define HMI_BITS_LAZY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "mat.h"
+#include "mat_ops.h"
+#include "vec.h"
+#include "vec_ops.h"
+
+namespace hmi {
+
+  // Opt-in expression templates: lazy(v) wraps a vector or a matrix and the
+  // operators on the wrapper build an expression that is only evaluated
+  // when it is converted back to a vec or a mat.
+
+  template<typename E>
+  class vec_expr;
+
+  template<typename E>
+  class mat_expr;
+
+  namespace detail {
+
+    struct expr_add {
+      template<typename T, typename U>
+      static constexpr auto apply(T lhs, U rhs) noexcept { return lhs + rhs; }
+    };
+
+    struct expr_sub {
+      template<typename T, typename U>
+      static constexpr auto apply(T lhs, U rhs) noexcept { return lhs - rhs; }
+    };
+
+    struct expr_mul {
+      template<typename T, typename U>
+      static constexpr auto apply(T lhs, U rhs) noexcept { return lhs * rhs; }
+    };
+
+    struct expr_div {
+      template<typename T, typename U>
+      static constexpr auto apply(T lhs, U rhs) noexcept { return lhs / rhs; }
+    };
+
+    // leaves
+
+    template<typename T>
+    struct scalar_node {
+      using value_type = T;
+      static constexpr std::size_t size = 0;
+
+      T value;
+
+      constexpr T operator[](std::size_t) const noexcept { return value; }
+      constexpr T operator()(std::size_t, std::size_t) const noexcept { return value; }
+    };
+
+    // lvalues are referenced, rvalues are copied so that an expression never outlives its operands
+
+    template<typename T, std::size_t N>
+    struct vec_ref_node {
+      using value_type = T;
+      static constexpr std::size_t size = N;
+
+      const vec<T, N> *v;
+
+      constexpr T operator[](std::size_t i) const noexcept { return (*v)[i]; }
+    };
+
+    template<typename T, std::size_t N>
+    struct vec_value_node {
+      using value_type = T;
+      static constexpr std::size_t size = N;
+
+      vec<T, N> v;
+
+      constexpr T operator[](std::size_t i) const noexcept { return v[i]; }
+    };
+
+    template<typename T, std::size_t N>
+    struct mat_ref_node {
+      using value_type = T;
+      static constexpr std::size_t size = N;
+
+      const mat<T, N> *m;
+
+      constexpr T operator()(std::size_t row, std::size_t col) const noexcept { return (*m)(row, col); }
+    };
+
+    template<typename T, std::size_t N>
+    struct mat_value_node {
+      using value_type = T;
+      static constexpr std::size_t size = N;
+
+      mat<T, N> m;
+
+      constexpr T operator()(std::size_t row, std::size_t col) const noexcept { return m(row, col); }
+    };
+
+    // element-wise nodes, shared by vectors and matrices; a scalar has size 0
+    // and combines with any shape
+
+    template<typename Op, typename L, typename R>
+    struct binary_node {
+      static_assert(L::size == 0 || R::size == 0 || L::size == R::size, "the operands should have the same size");
+
+      using value_type = std::common_type_t<typename L::value_type, typename R::value_type>;
+      static constexpr std::size_t size = std::max(L::size, R::size);
+
+      L lhs;
+      R rhs;
+
+      constexpr value_type operator[](std::size_t i) const noexcept {
+        return Op::apply(lhs[i], rhs[i]);
+      }
+
+      constexpr value_type operator()(std::size_t row, std::size_t col) const noexcept {
+        return Op::apply(lhs(row, col), rhs(row, col));
+      }
+    };
+
+    template<typename E>
+    struct negate_node {
+      using value_type = typename E::value_type;
+      static constexpr std::size_t size = E::size;
+
+      E operand;
+
+      constexpr value_type operator[](std::size_t i) const noexcept { return - operand[i]; }
+      constexpr value_type operator()(std::size_t row, std::size_t col) const noexcept { return - operand(row, col); }
+    };
+
+    // matrix product, it has no element access and is evaluated as a whole
+
+    template<typename L, typename R>
+    struct product_node {
+      static_assert(L::size == R::size, "the matrices should have the same size");
+
+      using value_type = std::common_type_t<typename L::value_type, typename R::value_type>;
+      static constexpr std::size_t size = L::size;
+
+      L lhs;
+      R rhs;
+    };
+
+    // traits
+
+    template<typename X>
+    inline constexpr bool is_vec_expr_v = false;
+
+    template<typename E>
+    inline constexpr bool is_vec_expr_v<vec_expr<E>> = true;
+
+    template<typename X>
+    inline constexpr bool is_mat_expr_v = false;
+
+    template<typename E>
+    inline constexpr bool is_mat_expr_v<mat_expr<E>> = true;
+
+    template<typename X>
+    inline constexpr bool is_vec_v = false;
+
+    template<typename T, std::size_t N>
+    inline constexpr bool is_vec_v<vec<T, N>> = true;
+
+    template<typename X>
+    inline constexpr bool is_mat_v = false;
+
+    template<typename T, std::size_t N>
+    inline constexpr bool is_mat_v<mat<T, N>> = true;
+
+    template<typename X>
+    inline constexpr bool is_product_node_v = false;
+
+    template<typename L, typename R>
+    inline constexpr bool is_product_node_v<product_node<L, R>> = true;
+
+    template<typename X>
+    using bare_t = std::remove_cv_t<std::remove_reference_t<X>>;
+
+    template<typename X>
+    inline constexpr bool is_vec_operand_v = is_vec_expr_v<bare_t<X>> || is_vec_v<bare_t<X>>;
+
+    template<typename X>
+    inline constexpr bool is_mat_operand_v = is_mat_expr_v<bare_t<X>> || is_mat_v<bare_t<X>>;
+
+    template<typename X>
+    inline constexpr bool is_scalar_operand_v = std::is_arithmetic_v<bare_t<X>>;
+
+    // the operators are only enabled when one of the operands is an expression
+
+    template<typename L, typename R>
+    inline constexpr bool enable_vec_ops_v = (is_vec_expr_v<bare_t<L>> || is_vec_expr_v<bare_t<R>>)
+      && (is_vec_operand_v<L> || is_scalar_operand_v<L>)
+      && (is_vec_operand_v<R> || is_scalar_operand_v<R>);
+
+    template<typename L, typename R>
+    inline constexpr bool enable_mat_ops_v = (is_mat_expr_v<bare_t<L>> || is_mat_expr_v<bare_t<R>>)
+      && is_mat_operand_v<L> && is_mat_operand_v<R>;
+
+    template<typename L, typename R>
+    inline constexpr bool enable_mat_scalar_ops_v = (is_mat_expr_v<bare_t<L>> && is_scalar_operand_v<R>)
+      || (is_scalar_operand_v<L> && is_mat_expr_v<bare_t<R>>);
+
+    template<typename L, typename R>
+    inline constexpr bool enable_mat_vec_ops_v = (is_mat_expr_v<bare_t<L>> || is_vec_expr_v<bare_t<R>>)
+      && is_mat_operand_v<L> && is_vec_operand_v<R>;
+
+    // conversion of the operands to nodes
+
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    constexpr scalar_node<T> make_node(T value) noexcept {
+      return { value };
+    }
+
+    template<typename T, std::size_t N>
+    constexpr vec_ref_node<T, N> make_node(const vec<T, N>& v) noexcept {
+      return { &v };
+    }
+
+    template<typename T, std::size_t N>
+    constexpr vec_value_node<T, N> make_node(vec<T, N>&& v) noexcept {
+      return { v };
+    }
+
+    template<typename E>
+    constexpr E make_node(const vec_expr<E>& e) noexcept {
+      return e.node();
+    }
+
+    template<typename T, std::size_t N>
+    constexpr mat_ref_node<T, N> make_node(const mat<T, N>& m) noexcept {
+      return { &m };
+    }
+
+    template<typename T, std::size_t N>
+    constexpr mat_value_node<T, N> make_node(mat<T, N>&& m) noexcept {
+      return { m };
+    }
+
+    template<typename E>
+    constexpr E make_node(const mat_expr<E>& e) noexcept {
+      return e.node();
+    }
+
+    // evaluation
+
+    template<typename E>
+    constexpr auto eval_mat(const E& node) {
+      if constexpr (is_product_node_v<E>) {
+        return eval_mat(node.lhs) * eval_mat(node.rhs);
+      } else {
+        mat<typename E::value_type, E::size> result{};
+
+        for (std::size_t i = 0; i < E::size; ++i) {
+          for (std::size_t j = 0; j < E::size; ++j) {
+            result(i, j) = node(i, j);
+          }
+        }
+
+        return result;
+      }
+    }
+
+    template<typename E, typename T, std::size_t N>
+    constexpr auto apply_mat(const E& node, const vec<T, N>& v) {
+      static_assert(E::size == N, "the matrix and the vector should have the same size");
+
+      if constexpr (is_product_node_v<E>) {
+        // (A * B) * v is computed as A * (B * v)
+        return apply_mat(node.lhs, apply_mat(node.rhs, v));
+      } else if constexpr (std::is_same_v<E, mat_ref_node<typename E::value_type, E::size>>) {
+        return *node.m * v;
+      } else {
+        return eval_mat(node) * v;
+      }
+    }
+
+    template<typename T, std::size_t N>
+    constexpr const vec<T, N>& to_vec(const vec<T, N>& v) noexcept {
+      return v;
+    }
+
+    template<typename E>
+    constexpr auto to_vec(const vec_expr<E>& e) noexcept {
+      return e.eval();
+    }
+
+    template<typename T, std::size_t N>
+    constexpr vec_expr<vec_value_node<T, N>> make_vec_value(const vec<T, N>& v) noexcept {
+      return vec_expr<vec_value_node<T, N>>({ v });
+    }
+
+    // a product is evaluated before taking part in an element-wise operation
+
+    template<typename X>
+    constexpr auto make_element_node(X&& operand) {
+      auto node = make_node(std::forward<X>(operand));
+
+      if constexpr (is_product_node_v<decltype(node)>) {
+        return mat_value_node<typename decltype(node)::value_type, decltype(node)::size>{ eval_mat(node) };
+      } else {
+        return node;
+      }
+    }
+
+    template<typename Op, typename L, typename R>
+    constexpr auto make_vec_binary(L&& lhs, R&& rhs) {
+      using node_type = binary_node<Op, decltype(make_node(std::forward<L>(lhs))), decltype(make_node(std::forward<R>(rhs)))>;
+      return vec_expr<node_type>(node_type{ make_node(std::forward<L>(lhs)), make_node(std::forward<R>(rhs)) });
+    }
+
+    template<typename Op, typename L, typename R>
+    constexpr auto make_mat_binary(L&& lhs, R&& rhs) {
+      using node_type = binary_node<Op, decltype(make_element_node(std::forward<L>(lhs))), decltype(make_element_node(std::forward<R>(rhs)))>;
+      return mat_expr<node_type>(node_type{ make_element_node(std::forward<L>(lhs)), make_element_node(std::forward<R>(rhs)) });
+    }
+
+  }
+
+  template<typename E>
+  class vec_expr {
+  public:
+    using value_type = typename E::value_type;
+    static constexpr std::size_t size = E::size;
+
+    constexpr explicit vec_expr(const E& node) noexcept
+    : m_node(node)
+    {
+
+    }
+
+    constexpr value_type operator[](std::size_t i) const noexcept {
+      return m_node[i];
+    }
+
+    constexpr const E& node() const noexcept {
+      return m_node;
+    }
+
+    constexpr vec<value_type, size> eval() const noexcept {
+      vec<value_type, size> result{};
+
+      for (std::size_t i = 0; i < size; ++i) {
+        result[i] = m_node[i];
+      }
+
+      return result;
+    }
+
+    template<typename U>
+    constexpr operator vec<U, size>() const noexcept {
+      vec<U, size> result{};
+
+      for (std::size_t i = 0; i < size; ++i) {
+        result[i] = static_cast<U>(m_node[i]);
+      }
+
+      return result;
+    }
+
+  private:
+    E m_node;
+  };
+
+  template<typename E>
+  class mat_expr {
+  public:
+    using value_type = typename E::value_type;
+    static constexpr std::size_t size = E::size;
+
+    constexpr explicit mat_expr(const E& node) noexcept
+    : m_node(node)
+    {
+
+    }
+
+    constexpr const E& node() const noexcept {
+      return m_node;
+    }
+
+    constexpr mat<value_type, size> eval() const {
+      return detail::eval_mat(m_node);
+    }
+
+    template<typename U>
+    constexpr operator mat<U, size>() const {
+      return mat<U, size>(eval());
+    }
+
+  private:
+    E m_node;
+  };
+
+  template<typename T, std::size_t N>
+  constexpr vec_expr<detail::vec_ref_node<T, N>> lazy(const vec<T, N>& v) noexcept {
+    return vec_expr<detail::vec_ref_node<T, N>>({ &v });
+  }
+
+  template<typename T, std::size_t N>
+  constexpr vec_expr<detail::vec_value_node<T, N>> lazy(vec<T, N>&& v) noexcept {
+    return vec_expr<detail::vec_value_node<T, N>>({ v });
+  }
+
+  template<typename T, std::size_t N>
+  constexpr mat_expr<detail::mat_ref_node<T, N>> lazy(const mat<T, N>& m) noexcept {
+    return mat_expr<detail::mat_ref_node<T, N>>({ &m });
+  }
+
+  template<typename T, std::size_t N>
+  constexpr mat_expr<detail::mat_value_node<T, N>> lazy(mat<T, N>&& m) noexcept {
+    return mat_expr<detail::mat_value_node<T, N>>({ m });
+  }
+
+  // vector expressions
+
+  template<typename E>
+  constexpr auto operator-(const vec_expr<E>& operand) noexcept {
+    return vec_expr<detail::negate_node<E>>({ operand.node() });
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_vec_ops_v<L, R>, int> = 0>
+  constexpr auto operator+(L&& lhs, R&& rhs) noexcept {
+    return detail::make_vec_binary<detail::expr_add>(std::forward<L>(lhs), std::forward<R>(rhs));
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_vec_ops_v<L, R>, int> = 0>
+  constexpr auto operator-(L&& lhs, R&& rhs) noexcept {
+    return detail::make_vec_binary<detail::expr_sub>(std::forward<L>(lhs), std::forward<R>(rhs));
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_vec_ops_v<L, R>, int> = 0>
+  constexpr auto operator*(L&& lhs, R&& rhs) noexcept {
+    return detail::make_vec_binary<detail::expr_mul>(std::forward<L>(lhs), std::forward<R>(rhs));
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_vec_ops_v<L, R>, int> = 0>
+  constexpr auto operator/(L&& lhs, R&& rhs) noexcept {
+    return detail::make_vec_binary<detail::expr_div>(std::forward<L>(lhs), std::forward<R>(rhs));
+  }
+
+  // matrix expressions
+
+  template<typename E>
+  constexpr auto operator-(const mat_expr<E>& operand) {
+    auto node = detail::make_element_node(operand);
+    return mat_expr<detail::negate_node<decltype(node)>>({ node });
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_mat_ops_v<L, R>, int> = 0>
+  constexpr auto operator+(L&& lhs, R&& rhs) {
+    return detail::make_mat_binary<detail::expr_add>(std::forward<L>(lhs), std::forward<R>(rhs));
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_mat_ops_v<L, R>, int> = 0>
+  constexpr auto operator-(L&& lhs, R&& rhs) {
+    return detail::make_mat_binary<detail::expr_sub>(std::forward<L>(lhs), std::forward<R>(rhs));
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_mat_scalar_ops_v<L, R>, int> = 0>
+  constexpr auto operator*(L&& lhs, R&& rhs) {
+    return detail::make_mat_binary<detail::expr_mul>(std::forward<L>(lhs), std::forward<R>(rhs));
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_mat_scalar_ops_v<L, R> && detail::is_scalar_operand_v<R>, int> = 0>
+  constexpr auto operator/(L&& lhs, R&& rhs) {
+    return detail::make_mat_binary<detail::expr_div>(std::forward<L>(lhs), std::forward<R>(rhs));
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_mat_ops_v<L, R>, int> = 0>
+  constexpr auto operator*(L&& lhs, R&& rhs) noexcept {
+    using node_type = detail::product_node<decltype(detail::make_node(std::forward<L>(lhs))), decltype(detail::make_node(std::forward<R>(rhs)))>;
+    return mat_expr<node_type>(node_type{ detail::make_node(std::forward<L>(lhs)), detail::make_node(std::forward<R>(rhs)) });
+  }
+
+  template<typename L, typename R, std::enable_if_t<detail::enable_mat_vec_ops_v<L, R>, int> = 0>
+  constexpr auto operator*(L&& lhs, R&& rhs) {
+    return detail::make_vec_value(detail::apply_mat(detail::make_node(std::forward<L>(lhs)), detail::to_vec(rhs)));
+  }
+
+}
+
+#endif // HMI_BITS_LAZY_H
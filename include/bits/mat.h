@@ -2,59 +2,34 @@
 #define HMI_BITS_MAT_H
 
 #include <cstddef>
-#include <initializer_list>
+#include <type_traits>
 
-namespace hmi {
-
-  template<typename T, std::size_t N, std::size_t IndexRow, std::size_t IndexCol>
-  struct mat_accessor {
-    static_assert(IndexCol < N, "IndexCol should be less than N");
-    static_assert(IndexRow < N, "IndexRow should be less than N");
-
-    T data[N][N];
-
-    constexpr operator T() const noexcept {
-      return data[IndexRow][IndexCol];
-    }
-
-    constexpr mat_accessor& operator=(T value) noexcept {
-      data[IndexRow][IndexCol] = value;
-      return *this;
-    }
+#include "vec.h"
 
-    constexpr T* operator&() noexcept {
-      return &data[IndexRow][IndexCol];
-    }
+namespace hmi {
 
-    constexpr const T* operator&() const noexcept {
-      return &data[IndexRow][IndexCol];
-    }
+  // the elements are stored row by row, an element has the accessor of its
+  // index in this order
 
-    constexpr mat_accessor& operator++() noexcept {
-      ++data[IndexRow][IndexCol];
-      return *this;
-    }
+  template<typename T, std::size_t C, std::size_t IndexRow, std::size_t IndexCol>
+  using mat_accessor = vec_accessor<T, IndexRow * C + IndexCol>;
 
-    constexpr mat_accessor operator++(int) noexcept {
-      mat_accessor copy(*this);
-      ++data[IndexRow][IndexCol];
-      return copy;
-    }
-  };
+  // a matrix with R rows and C columns, square by default
 
-  template<typename T, std::size_t N>
+  template<typename T, std::size_t R, std::size_t C>
   struct mat {
-    T data[N][N];
+    T data[R][C];
 
-    mat() {
-    }
+    mat() = default;
 
     mat(const mat& other) = default;
 
     template<typename U>
-    mat(const mat<U, N>& other) noexcept {
-      for (std::size_t i = 0; i < N; ++i) {
-        for (std::size_t j = 0; j < N; ++j) {
+    constexpr mat(const mat<U, R, C>& other) noexcept
+    : data{}
+    {
+      for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) {
           data[i][j] = static_cast<T>(other.data[i][j]);
         }
       }
@@ -70,7 +45,7 @@ namespace hmi {
   };
 
   template<typename T>
-  struct mat<T, 2> {
+  struct mat<T, 2, 2> {
     union {
       T data[2][2];
 
@@ -80,8 +55,7 @@ namespace hmi {
       mat_accessor<T, 2, 1, 1> yy;
     };
 
-    mat() {
-    }
+    mat() = default;
 
     constexpr mat(T xx, T xy, T yx, T yy) noexcept
     : data{ { xx, xy }, { yx, yy } }
@@ -92,7 +66,9 @@ namespace hmi {
     mat(const mat& other) = default;
 
     template<typename U>
-    mat(const mat<U, 2>& other) noexcept {
+    constexpr mat(const mat<U, 2, 2>& other) noexcept
+    : data{}
+    {
       for (std::size_t i = 0; i < 2; ++i) {
         for (std::size_t j = 0; j < 2; ++j) {
           data[i][j] = static_cast<T>(other.data[i][j]);
@@ -110,7 +86,7 @@ namespace hmi {
   };
 
   template<typename T>
-  struct mat<T, 3> {
+  struct mat<T, 3, 3> {
     union {
       T data[3][3];
 
@@ -125,8 +101,7 @@ namespace hmi {
       mat_accessor<T, 3, 2, 2> zz;
     };
 
-    mat() {
-    }
+    mat() = default;
 
     constexpr mat(T xx, T xy, T xz, T yx, T yy, T yz, T zx, T zy, T zz) noexcept
     : data{ { xx, xy, xz }, { yx, yy, yz }, { zx, zy, zz } }
@@ -137,7 +112,9 @@ namespace hmi {
     mat(const mat& other) = default;
 
     template<typename U>
-    mat(const mat<U, 3>& other) noexcept {
+    constexpr mat(const mat<U, 3, 3>& other) noexcept
+    : data{}
+    {
       for (std::size_t i = 0; i < 3; ++i) {
         for (std::size_t j = 0; j < 3; ++j) {
           data[i][j] = static_cast<T>(other.data[i][j]);
@@ -156,7 +133,7 @@ namespace hmi {
 
 
   template<typename T>
-  struct mat<T, 4> {
+  struct mat<T, 4, 4> {
     union {
       T data[4][4];
 
@@ -178,8 +155,7 @@ namespace hmi {
       mat_accessor<T, 4, 3, 3> ww;
     };
 
-    mat() {
-    }
+    mat() = default;
 
     constexpr mat(T xx, T xy, T xz, T xw, T yx, T yy, T yz, T yw, T zx, T zy, T zz, T zw, T wx, T wy, T wz, T ww) noexcept
     : data{ { xx, xy, xz, xw }, { yx, yy, yz, yw }, { zx, zy, zz, zw }, { wx, wy, wz, ww  } }
@@ -190,7 +166,9 @@ namespace hmi {
     mat(const mat& other) = default;
 
     template<typename U>
-    mat(const mat<U, 4>& other) noexcept {
+    constexpr mat(const mat<U, 4, 4>& other) noexcept
+    : data{}
+    {
       for (std::size_t i = 0; i < 4; ++i) {
         for (std::size_t j = 0; j < 4; ++j) {
           data[i][j] = static_cast<T>(other.data[i][j]);
@@ -207,33 +185,136 @@ namespace hmi {
     }
   };
 
+  // the two first rows of a 2D affine transformation, see transform2
 
   template<typename T>
-  using mat2 = mat<T, 2>;
+  struct mat<T, 2, 3> {
+    union {
+      T data[2][3];
 
-  using mat2f = mat2<float>;
+      mat_accessor<T, 3, 0, 0> xx;
+      mat_accessor<T, 3, 0, 1> xy;
+      mat_accessor<T, 3, 0, 2> xz;
+      mat_accessor<T, 3, 1, 0> yx;
+      mat_accessor<T, 3, 1, 1> yy;
+      mat_accessor<T, 3, 1, 2> yz;
+    };
 
-  using mat2d = mat2<double>;
+    mat() = default;
 
-  using mat2i = mat2<int>;
+    constexpr mat(T xx, T xy, T xz, T yx, T yy, T yz) noexcept
+    : data{ { xx, xy, xz }, { yx, yy, yz } }
+    {
 
-  template<typename T>
-  using mat3 = mat<T, 3>;
+    }
 
-  using mat3f = mat3<float>;
+    mat(const mat& other) = default;
+
+    template<typename U>
+    constexpr mat(const mat<U, 2, 3>& other) noexcept
+    : data{}
+    {
+      for (std::size_t i = 0; i < 2; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+          data[i][j] = static_cast<T>(other.data[i][j]);
+        }
+      }
+    }
+
+    static constexpr mat identity() noexcept {
+      return mat(T(1), T(0), T(0), T(0), T(1), T(0));
+    }
+
+    static constexpr mat translation(vec<T, 2> offset) noexcept {
+      return mat(T(1), T(0), offset[0], T(0), T(1), offset[1]);
+    }
+
+    static constexpr mat scaling(vec<T, 2> factors) noexcept {
+      return mat(factors[0], T(0), T(0), T(0), factors[1], T(0));
+    }
+
+    constexpr T operator()(std::size_t row, std::size_t col) const noexcept {
+      return data[row][col];
+    }
 
-  using mat3d = mat3<double>;
+    constexpr T& operator()(std::size_t row, std::size_t col) noexcept {
+      return data[row][col];
+    }
+  };
 
-  using mat3i = mat3<int>;
+  // the three first rows of a 3D affine transformation, each row fills a float4
 
   template<typename T>
-  using mat4 = mat<T, 4>;
+  struct mat<T, 3, 4> {
+    union {
+      T data[3][4];
+
+      mat_accessor<T, 4, 0, 0> xx;
+      mat_accessor<T, 4, 0, 1> xy;
+      mat_accessor<T, 4, 0, 2> xz;
+      mat_accessor<T, 4, 0, 3> xw;
+      mat_accessor<T, 4, 1, 0> yx;
+      mat_accessor<T, 4, 1, 1> yy;
+      mat_accessor<T, 4, 1, 2> yz;
+      mat_accessor<T, 4, 1, 3> yw;
+      mat_accessor<T, 4, 2, 0> zx;
+      mat_accessor<T, 4, 2, 1> zy;
+      mat_accessor<T, 4, 2, 2> zz;
+      mat_accessor<T, 4, 2, 3> zw;
+    };
 
-  using mat4f = mat4<float>;
+    mat() = default;
+
+    constexpr mat(T xx, T xy, T xz, T xw, T yx, T yy, T yz, T yw, T zx, T zy, T zz, T zw) noexcept
+    : data{ { xx, xy, xz, xw }, { yx, yy, yz, yw }, { zx, zy, zz, zw } }
+    {
+
+    }
+
+    mat(const mat& other) = default;
 
-  using mat4d = mat4<double>;
+    template<typename U>
+    constexpr mat(const mat<U, 3, 4>& other) noexcept
+    : data{}
+    {
+      for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+          data[i][j] = static_cast<T>(other.data[i][j]);
+        }
+      }
+    }
+
+    constexpr T operator()(std::size_t row, std::size_t col) const noexcept {
+      return data[row][col];
+    }
+
+    constexpr T& operator()(std::size_t row, std::size_t col) noexcept {
+      return data[row][col];
+    }
+  };
+
+  // a matrix aligned on 16 bytes, see aligned_vec
+
+  template<typename T, std::size_t R, std::size_t C>
+  struct alignas(16) aligned_mat : mat<T, R, C> {
+    using mat<T, R, C>::mat;
+
+    aligned_mat() = default;
+
+    constexpr aligned_mat(const mat<T, R, C>& other) noexcept
+    : mat<T, R, C>(other)
+    {
+
+    }
+  };
 
-  using mat4i = mat4<int>;
+  static_assert(std::is_trivial_v<mat2f> && std::is_standard_layout_v<mat2f> && sizeof(mat2f) == 4 * sizeof(float) && alignof(mat2f) == alignof(float));
+  static_assert(std::is_trivial_v<mat3f> && std::is_standard_layout_v<mat3f> && sizeof(mat3f) == 9 * sizeof(float) && alignof(mat3f) == alignof(float));
+  static_assert(std::is_trivial_v<mat4f> && std::is_standard_layout_v<mat4f> && sizeof(mat4f) == 16 * sizeof(float) && alignof(mat4f) == alignof(float));
+  static_assert(std::is_trivial_v<mat2x3f> && std::is_standard_layout_v<mat2x3f> && sizeof(mat2x3f) == 6 * sizeof(float) && alignof(mat2x3f) == alignof(float));
+  static_assert(std::is_trivial_v<mat3x4f> && std::is_standard_layout_v<mat3x4f> && sizeof(mat3x4f) == 12 * sizeof(float) && alignof(mat3x4f) == alignof(float));
+  static_assert(std::is_trivial_v<mat4f_a> && sizeof(mat4f_a) == 64 && alignof(mat4f_a) == 16);
+  static_assert(std::is_trivial_v<mat3x4f_a> && sizeof(mat3x4f_a) == 48 && alignof(mat3x4f_a) == 16);
 
 } // namespace hmi
 
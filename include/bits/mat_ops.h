@@ -1,15 +1,18 @@
 #ifndef HMI_BITS_MAT_OPS_H
 #define HMI_BITS_MAT_OPS_H
 
+#include <type_traits>
+
 #include "mat.h"
+#include "mat_simd.h"
 #include "vec.h"
 
 namespace hmi {
-  template<typename T, std::size_t N>
+  template<typename T, std::size_t R, std::size_t C>
   constexpr
-  bool operator==(const mat<T, N>& lhs, const mat<T, N>& rhs) {
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+  bool operator==(const mat<T, R, C>& lhs, const mat<T, R, C>& rhs) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         if (lhs(i, j) != rhs(i, j)) {
           return false;
         }
@@ -19,19 +22,19 @@ namespace hmi {
     return true;
   }
 
-  template<typename T, std::size_t N>
+  template<typename T, std::size_t R, std::size_t C>
   constexpr
-  bool operator!=(const mat<T, N>& lhs, const mat<T, N>& rhs) {
+  bool operator!=(const mat<T, R, C>& lhs, const mat<T, R, C>& rhs) {
     return !(lhs == rhs);
   }
 
-  template<typename T, std::size_t N>
+  template<typename T, std::size_t R, std::size_t C>
   constexpr
-  mat<T, N> operator-(const mat<T, N>& m) {
-    mat<T, N> result;
+  mat<T, R, C> operator-(const mat<T, R, C>& m) {
+    mat<T, R, C> result{};
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         result(i, j) = - m(i, j);
       }
     }
@@ -39,13 +42,21 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<std::common_type_t<T,U>, N> operator+(const mat<T, N>& lhs, const mat<U, N>& rhs) {
-    mat<std::common_type_t<T,U>, N> result;
+  mat<std::common_type_t<T,U>, R, C> operator+(const mat<T, R, C>& lhs, const mat<U, R, C>& rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, R, C>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_add(lhs, rhs);
+      }
+    }
+#endif
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    mat<std::common_type_t<T,U>, R, C> result{};
+
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         result(i, j) = lhs(i, j) + rhs(i, j);
       }
     }
@@ -53,11 +64,19 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<T, N>& operator+=(mat<T, N>& lhs, const mat<U, N>& rhs) {
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+  mat<T, R, C>& operator+=(mat<T, R, C>& lhs, const mat<U, R, C>& rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, R, C>) {
+      if (!detail::is_constant_evaluated()) {
+        return lhs = detail::simd_add(lhs, rhs);
+      }
+    }
+#endif
+
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         lhs(i, j) += rhs(i, j);
       }
     }
@@ -65,13 +84,21 @@ namespace hmi {
     return lhs;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<std::common_type_t<T,U>, N> operator-(const mat<T, N>& lhs, const mat<U, N>& rhs) {
-    mat<std::common_type_t<T,U>, N> result;
+  mat<std::common_type_t<T,U>, R, C> operator-(const mat<T, R, C>& lhs, const mat<U, R, C>& rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, R, C>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_sub(lhs, rhs);
+      }
+    }
+#endif
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    mat<std::common_type_t<T,U>, R, C> result{};
+
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         result(i, j) = lhs(i, j) - rhs(i, j);
       }
     }
@@ -79,11 +106,19 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<T, N>& operator-=(mat<T, N>& lhs, const mat<U, N>& rhs) {
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+  mat<T, R, C>& operator-=(mat<T, R, C>& lhs, const mat<U, R, C>& rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, R, C>) {
+      if (!detail::is_constant_evaluated()) {
+        return lhs = detail::simd_sub(lhs, rhs);
+      }
+    }
+#endif
+
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         lhs(i, j) -= rhs(i, j);
       }
     }
@@ -91,13 +126,21 @@ namespace hmi {
     return lhs;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<std::common_type_t<T,U>, N> operator*(const mat<T, N>& lhs, U rhs) {
-    mat<std::common_type_t<T,U>, N> result;
+  mat<std::common_type_t<T,U>, R, C> operator*(const mat<T, R, C>& lhs, U rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, R, C>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_scale(lhs, rhs);
+      }
+    }
+#endif
+
+    mat<std::common_type_t<T,U>, R, C> result{};
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         result(i,j) = lhs(i,j) * rhs;
       }
     }
@@ -105,11 +148,19 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<T, N>& operator*=(mat<T, N>& lhs, U rhs) {
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+  mat<T, R, C>& operator*=(mat<T, R, C>& lhs, U rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, R, C>) {
+      if (!detail::is_constant_evaluated()) {
+        return lhs = detail::simd_scale(lhs, rhs);
+      }
+    }
+#endif
+
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         lhs(i,j) *= rhs;
       }
     }
@@ -117,13 +168,21 @@ namespace hmi {
     return lhs;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<std::common_type_t<T,U>, N> operator*(T lhs, const mat<U, N>& rhs) {
-    mat<std::common_type_t<T,U>, N> result;
+  mat<std::common_type_t<T,U>, R, C> operator*(T lhs, const mat<U, R, C>& rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, R, C>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_scale(rhs, lhs);
+      }
+    }
+#endif
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    mat<std::common_type_t<T,U>, R, C> result{};
+
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         result(i,j) = lhs * rhs(i,j);
       }
     }
@@ -131,13 +190,13 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<std::common_type_t<T,U>, N> operator/(const mat<T, N>& lhs, U rhs) {
-    mat<std::common_type_t<T,U>, N> result;
+  mat<std::common_type_t<T,U>, R, C> operator/(const mat<T, R, C>& lhs, U rhs) {
+    mat<std::common_type_t<T,U>, R, C> result{};
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         result(i,j) = lhs(i,j) / rhs;
       }
     }
@@ -145,11 +204,11 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<T, N>& operator/=(mat<T, N>& lhs, U rhs) {
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+  mat<T, R, C>& operator/=(mat<T, R, C>& lhs, U rhs) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         lhs(i,j) /= rhs;
       }
     }
@@ -157,13 +216,13 @@ namespace hmi {
     return lhs;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<std::common_type_t<T,U>, N> operator/(T lhs, const mat<U, N>& rhs) {
-    mat<std::common_type_t<T,U>, N> result;
+  mat<std::common_type_t<T,U>, R, C> operator/(T lhs, const mat<U, R, C>& rhs) {
+    mat<std::common_type_t<T,U>, R, C> result{};
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         result(i,j) = lhs / rhs(i,j);
       }
     }
@@ -171,15 +230,26 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  // the products are defined when the inner dimensions match: a R x C matrix
+  // maps a vector of size C to a vector of size R
+
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  vec<std::common_type_t<T,U>, N> operator*(const mat<T, N>& lhs, const vec<U, N>& rhs) {
-    vec<std::common_type_t<T,U>, N> result;
+  vec<std::common_type_t<T,U>, R> operator*(const mat<T, R, C>& lhs, const vec<U, C>& rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, R, C> && C == 4) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_mul(lhs, rhs);
+      }
+    }
+#endif
 
-    for (std::size_t i = 0; i < N; ++i) {
+    vec<std::common_type_t<T,U>, R> result{};
+
+    for (std::size_t i = 0; i < R; ++i) {
       std::common_type_t<T,U> value = 0;
 
-      for (std::size_t j = 0; j < N; ++j) {
+      for (std::size_t j = 0; j < C; ++j) {
         value += lhs(i, j) * rhs[j];
       }
 
@@ -189,16 +259,16 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  vec<std::common_type_t<T,U>, N> operator*(const vec<T, N>& lhs, const mat<U, N>& rhs) {
-    vec<std::common_type_t<T,U>, N> result;
+  vec<std::common_type_t<T,U>, C> operator*(const vec<T, R>& lhs, const mat<U, R, C>& rhs) {
+    vec<std::common_type_t<T,U>, C> result{};
 
-    for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t j = 0; j < C; ++j) {
       std::common_type_t<T,U> value = 0;
 
-      for (std::size_t i = 0; i < N; ++i) {
-        value += lhs[j] * rhs(i, j);
+      for (std::size_t i = 0; i < R; ++i) {
+        value += lhs[i] * rhs(i, j);
       }
 
       result[j] = value;
@@ -207,16 +277,24 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  template<typename T, typename U, std::size_t R, std::size_t K, std::size_t C>
   constexpr
-  mat<std::common_type_t<T, U>, N> operator*(const mat<T, N>& lhs, const mat<U, N>& rhs) {
-    mat<std::common_type_t<T, U>, N> result;
+  mat<std::common_type_t<T, U>, R, C> operator*(const mat<T, R, K>& lhs, const mat<U, K, C>& rhs) {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_mat_v<T, U, K, C>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_mul(lhs, rhs);
+      }
+    }
+#endif
+
+    mat<std::common_type_t<T, U>, R, C> result{};
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         std::common_type_t<T, U> value = 0;
 
-        for (std::size_t k = 0; k < N; ++k) {
+        for (std::size_t k = 0; k < K; ++k) {
           value += lhs(i, k) * rhs(k, j);
         }
 
@@ -227,36 +305,43 @@ namespace hmi {
     return result;
   }
 
-  template<typename T, typename U, std::size_t N>
+  // the product keeps the shape of lhs, so rhs is square
+
+  template<typename T, typename U, std::size_t R, std::size_t C>
   constexpr
-  mat<T, N>& operator*=(mat<T, N>& lhs, const mat<U, N>& rhs) {
+  mat<T, R, C>& operator*=(mat<T, R, C>& lhs, const mat<U, C, C>& rhs) {
     lhs = lhs * rhs;
     return lhs;
   }
 
-  template<typename T, std::size_t N>
+  template<typename T, std::size_t R, std::size_t C>
   constexpr
-  mat<T, N> transpose(const mat<T, N>& m) {
-    mat<T, N> result;
+  mat<T, C, R> transpose(const mat<T, R, C>& m) {
+    mat<T, C, R> result{};
 
-    for (std::size_t i = 0; i < N; ++i) {
-      for (std::size_t j = 0; j < N; ++j) {
+    for (std::size_t i = 0; i < R; ++i) {
+      for (std::size_t j = 0; j < C; ++j) {
         result(j, i) = m(i, j);
       }
     }
+
+    return result;
   }
 
+  // the accessors are not used in the following functions, they are not
+  // active members of the union in constant expressions
+
   template<typename T>
   constexpr
   mat<T, 2> invert(const mat<T, 2>& input) {
-    mat<T, 2> result;
+    mat<T, 2> result{};
 
-    result.xx = input.yy;
-    result.xy = - input.xy;
-    result.yx = - input.yx;
-    result.yy = input.xx;
+    result(0, 0) = input(1, 1);
+    result(0, 1) = - input(0, 1);
+    result(1, 0) = - input(1, 0);
+    result(1, 1) = input(0, 0);
 
-    T det = input.xx * input.yy - input.yx * input.xy;
+    T det = input(0, 0) * input(1, 1) - input(1, 0) * input(0, 1);
     result /= det;
     return result;
   }
@@ -264,23 +349,159 @@ namespace hmi {
   template<typename T>
   constexpr
   mat<T, 3> invert(const mat<T, 3>& input) {
-    mat<T, 3> result;
-
-    result.xx = input.yy * input.zz - input.zy * input.yz;
-    result.xy = - (input.xy * input.zz - input.zy * input.xz);
-    result.xz = input.xy * input.yz - input.yy * input.xz;
-    result.yx = - (input.yx * input.zz - input.zx * input.yz);
-    result.yy = input.xx * input.zz - input.zx * input.xz;
-    result.yz = - (input.xx * input.yz - input.yx * input.xz);
-    result.zx = input.yx * input.zy - input.zx * input.yy;
-    result.zy = - (input.xx * input.zy - input.zx * input.xy);
-    result.zz = input.xx * input.yy - input.yx * input.xy;
-
-    T det = input.xx * result.xx + input.xy * result.yx + input.xz * result.zx;
+    mat<T, 3> result{};
+
+    result(0, 0) = input(1, 1) * input(2, 2) - input(2, 1) * input(1, 2);
+    result(0, 1) = - (input(0, 1) * input(2, 2) - input(2, 1) * input(0, 2));
+    result(0, 2) = input(0, 1) * input(1, 2) - input(1, 1) * input(0, 2);
+    result(1, 0) = - (input(1, 0) * input(2, 2) - input(2, 0) * input(1, 2));
+    result(1, 1) = input(0, 0) * input(2, 2) - input(2, 0) * input(0, 2);
+    result(1, 2) = - (input(0, 0) * input(1, 2) - input(1, 0) * input(0, 2));
+    result(2, 0) = input(1, 0) * input(2, 1) - input(2, 0) * input(1, 1);
+    result(2, 1) = - (input(0, 0) * input(2, 1) - input(2, 0) * input(0, 1));
+    result(2, 2) = input(0, 0) * input(1, 1) - input(1, 0) * input(0, 1);
+
+    T det = input(0, 0) * result(0, 0) + input(0, 1) * result(1, 0) + input(0, 2) * result(2, 0);
+    result /= det;
+    return result;
+  }
+
+  template<typename T>
+  constexpr
+  mat<T, 4> invert(const mat<T, 4>& input) {
+#if defined(HMI_SIMD_DISPATCH) && defined(HMI_SIMD_SSE2)
+    if constexpr (detail::is_simd_mat_v<T, T, 4>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_invert(input);
+      }
+    }
+#endif
+
+    // 2x2 determinants of the two upper rows and the two lower rows
+    T s0 = input(0, 0) * input(1, 1) - input(1, 0) * input(0, 1);
+    T s1 = input(0, 0) * input(1, 2) - input(1, 0) * input(0, 2);
+    T s2 = input(0, 0) * input(1, 3) - input(1, 0) * input(0, 3);
+    T s3 = input(0, 1) * input(1, 2) - input(1, 1) * input(0, 2);
+    T s4 = input(0, 1) * input(1, 3) - input(1, 1) * input(0, 3);
+    T s5 = input(0, 2) * input(1, 3) - input(1, 2) * input(0, 3);
+
+    T c5 = input(2, 2) * input(3, 3) - input(3, 2) * input(2, 3);
+    T c4 = input(2, 1) * input(3, 3) - input(3, 1) * input(2, 3);
+    T c3 = input(2, 1) * input(3, 2) - input(3, 1) * input(2, 2);
+    T c2 = input(2, 0) * input(3, 3) - input(3, 0) * input(2, 3);
+    T c1 = input(2, 0) * input(3, 2) - input(3, 0) * input(2, 2);
+    T c0 = input(2, 0) * input(3, 1) - input(3, 0) * input(2, 1);
+
+    mat<T, 4> result{};
+
+    result(0, 0) = input(1, 1) * c5 - input(1, 2) * c4 + input(1, 3) * c3;
+    result(0, 1) = - input(0, 1) * c5 + input(0, 2) * c4 - input(0, 3) * c3;
+    result(0, 2) = input(3, 1) * s5 - input(3, 2) * s4 + input(3, 3) * s3;
+    result(0, 3) = - input(2, 1) * s5 + input(2, 2) * s4 - input(2, 3) * s3;
+
+    result(1, 0) = - input(1, 0) * c5 + input(1, 2) * c2 - input(1, 3) * c1;
+    result(1, 1) = input(0, 0) * c5 - input(0, 2) * c2 + input(0, 3) * c1;
+    result(1, 2) = - input(3, 0) * s5 + input(3, 2) * s2 - input(3, 3) * s1;
+    result(1, 3) = input(2, 0) * s5 - input(2, 2) * s2 + input(2, 3) * s1;
+
+    result(2, 0) = input(1, 0) * c4 - input(1, 1) * c2 + input(1, 3) * c0;
+    result(2, 1) = - input(0, 0) * c4 + input(0, 1) * c2 - input(0, 3) * c0;
+    result(2, 2) = input(3, 0) * s4 - input(3, 1) * s2 + input(3, 3) * s0;
+    result(2, 3) = - input(2, 0) * s4 + input(2, 1) * s2 - input(2, 3) * s0;
+
+    result(3, 0) = - input(1, 0) * c3 + input(1, 1) * c1 - input(1, 2) * c0;
+    result(3, 1) = input(0, 0) * c3 - input(0, 1) * c1 + input(0, 2) * c0;
+    result(3, 2) = - input(3, 0) * s3 + input(3, 1) * s1 - input(3, 2) * s0;
+    result(3, 3) = input(2, 0) * s3 - input(2, 1) * s1 + input(2, 2) * s0;
+
+    T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
     result /= det;
     return result;
   }
 
+  // inverse of an affine transformation: the last row must be (0, ..., 0, 1),
+  // only the linear part is inverted and the translation follows
+
+  template<typename T>
+  constexpr
+  mat<T, 3> invert_affine(const mat<T, 3>& input) {
+    T det = input(0, 0) * input(1, 1) - input(1, 0) * input(0, 1);
+
+    T xx = input(1, 1) / det;
+    T xy = - input(0, 1) / det;
+    T yx = - input(1, 0) / det;
+    T yy = input(0, 0) / det;
+
+    return mat<T, 3>(
+      xx,   xy,   - (xx * input(0, 2) + xy * input(1, 2)),
+      yx,   yy,   - (yx * input(0, 2) + yy * input(1, 2)),
+      T(0), T(0), T(1)
+    );
+  }
+
+  template<typename T>
+  constexpr
+  mat<T, 4> invert_affine(const mat<T, 4>& input) {
+    mat<T, 4> result{};
+
+    result(0, 0) = input(1, 1) * input(2, 2) - input(2, 1) * input(1, 2);
+    result(0, 1) = - (input(0, 1) * input(2, 2) - input(2, 1) * input(0, 2));
+    result(0, 2) = input(0, 1) * input(1, 2) - input(1, 1) * input(0, 2);
+    result(1, 0) = - (input(1, 0) * input(2, 2) - input(2, 0) * input(1, 2));
+    result(1, 1) = input(0, 0) * input(2, 2) - input(2, 0) * input(0, 2);
+    result(1, 2) = - (input(0, 0) * input(1, 2) - input(1, 0) * input(0, 2));
+    result(2, 0) = input(1, 0) * input(2, 1) - input(2, 0) * input(1, 1);
+    result(2, 1) = - (input(0, 0) * input(2, 1) - input(2, 0) * input(0, 1));
+    result(2, 2) = input(0, 0) * input(1, 1) - input(1, 0) * input(0, 1);
+
+    T det = input(0, 0) * result(0, 0) + input(0, 1) * result(1, 0) + input(0, 2) * result(2, 0);
+
+    for (std::size_t i = 0; i < 3; ++i) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        result(i, j) /= det;
+      }
+    }
+
+    for (std::size_t i = 0; i < 3; ++i) {
+      result(i, 3) = - (result(i, 0) * input(0, 3) + result(i, 1) * input(1, 3) + result(i, 2) * input(2, 3));
+    }
+
+    result(3, 3) = T(1);
+    return result;
+  }
+
+  // inverse of a rigid transformation: the linear part must be a rotation,
+  // its inverse is its transpose
+
+  template<typename T>
+  constexpr
+  mat<T, 3> invert_rigid(const mat<T, 3>& input) {
+    return mat<T, 3>(
+      input(0, 0), input(1, 0), - (input(0, 0) * input(0, 2) + input(1, 0) * input(1, 2)),
+      input(0, 1), input(1, 1), - (input(0, 1) * input(0, 2) + input(1, 1) * input(1, 2)),
+      T(0),        T(0),        T(1)
+    );
+  }
+
+  template<typename T>
+  constexpr
+  mat<T, 4> invert_rigid(const mat<T, 4>& input) {
+    mat<T, 4> result{};
+
+    for (std::size_t i = 0; i < 3; ++i) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        result(i, j) = input(j, i);
+      }
+    }
+
+    for (std::size_t i = 0; i < 3; ++i) {
+      result(i, 3) = - (result(i, 0) * input(0, 3) + result(i, 1) * input(1, 3) + result(i, 2) * input(2, 3));
+    }
+
+    result(3, 3) = T(1);
+    return result;
+  }
+
 }
 
 #endif // HMI_BITS_MAT_OPS_H
@@ -0,0 +1,266 @@
+#ifndef HMI_BITS_MAT_SIMD_H
+#define HMI_BITS_MAT_SIMD_H
+
+#include <cstddef>
+
+#include "mat.h"
+#include "simd.h"
+#include "vec.h"
+
+namespace hmi {
+
+  namespace detail {
+
+    template<typename T, typename U, std::size_t R, std::size_t C = R>
+    inline constexpr bool is_simd_mat_v = false;
+
+#if defined(HMI_SIMD_DISPATCH)
+
+    template<>
+    inline constexpr bool is_simd_mat_v<float, float, 3, 3> = true;
+
+    template<>
+    inline constexpr bool is_simd_mat_v<float, float, 3, 4> = true;
+
+    template<>
+    inline constexpr bool is_simd_mat_v<float, float, 4, 4> = true;
+
+    // the 9 elements of a mat3f are handled as two float4 and a scalar
+
+    inline mat3f simd_add(const mat3f& lhs, const mat3f& rhs) {
+      const float *a = &lhs.data[0][0];
+      const float *b = &rhs.data[0][0];
+      mat3f result;
+      float *r = &result.data[0][0];
+      store4(r, add4(load4(a), load4(b)));
+      store4(r + 4, add4(load4(a + 4), load4(b + 4)));
+      r[8] = a[8] + b[8];
+      return result;
+    }
+
+    inline mat3f simd_sub(const mat3f& lhs, const mat3f& rhs) {
+      const float *a = &lhs.data[0][0];
+      const float *b = &rhs.data[0][0];
+      mat3f result;
+      float *r = &result.data[0][0];
+      store4(r, sub4(load4(a), load4(b)));
+      store4(r + 4, sub4(load4(a + 4), load4(b + 4)));
+      r[8] = a[8] - b[8];
+      return result;
+    }
+
+    inline mat3f simd_scale(const mat3f& lhs, float rhs) {
+      const float *a = &lhs.data[0][0];
+      float4 s = splat4(rhs);
+      mat3f result;
+      float *r = &result.data[0][0];
+      store4(r, mul4(load4(a), s));
+      store4(r + 4, mul4(load4(a + 4), s));
+      r[8] = a[8] * rhs;
+      return result;
+    }
+
+    // the last row can not be loaded directly with 4 floats
+
+    inline float4 load_row3(const float *p) {
+      const float row[4] = { p[0], p[1], p[2], 0.0f };
+      return load4(row);
+    }
+
+    template<std::size_t R>
+    mat<float, R, 3> simd_mul(const mat<float, R, 3>& lhs, const mat3f& rhs) {
+      float4 b0 = load4(rhs.data[0]);
+      float4 b1 = load4(rhs.data[1]);
+      float4 b2 = load_row3(rhs.data[2]);
+
+      mat<float, R, 3> result;
+
+      for (std::size_t i = 0; i < R; ++i) {
+        float4 row = mul4(splat4(lhs.data[i][0]), b0);
+        row = madd4(splat4(lhs.data[i][1]), b1, row);
+        row = madd4(splat4(lhs.data[i][2]), b2, row);
+
+        float tmp[4];
+        store4(tmp, row);
+        result.data[i][0] = tmp[0];
+        result.data[i][1] = tmp[1];
+        result.data[i][2] = tmp[2];
+      }
+
+      return result;
+    }
+
+    // with 4 columns, each row is a float4: mat4f and mat3x4f share the kernels
+
+    template<std::size_t R>
+    mat<float, R, 4> simd_add(const mat<float, R, 4>& lhs, const mat<float, R, 4>& rhs) {
+      mat<float, R, 4> result;
+
+      for (std::size_t i = 0; i < R; ++i) {
+        store4(result.data[i], add4(load4(lhs.data[i]), load4(rhs.data[i])));
+      }
+
+      return result;
+    }
+
+    template<std::size_t R>
+    mat<float, R, 4> simd_sub(const mat<float, R, 4>& lhs, const mat<float, R, 4>& rhs) {
+      mat<float, R, 4> result;
+
+      for (std::size_t i = 0; i < R; ++i) {
+        store4(result.data[i], sub4(load4(lhs.data[i]), load4(rhs.data[i])));
+      }
+
+      return result;
+    }
+
+    template<std::size_t R>
+    mat<float, R, 4> simd_scale(const mat<float, R, 4>& lhs, float rhs) {
+      float4 s = splat4(rhs);
+      mat<float, R, 4> result;
+
+      for (std::size_t i = 0; i < R; ++i) {
+        store4(result.data[i], mul4(load4(lhs.data[i]), s));
+      }
+
+      return result;
+    }
+
+    template<std::size_t R, std::size_t K>
+    mat<float, R, 4> simd_mul(const mat<float, R, K>& lhs, const mat<float, K, 4>& rhs) {
+      float4 b[K];
+
+      for (std::size_t k = 0; k < K; ++k) {
+        b[k] = load4(rhs.data[k]);
+      }
+
+      mat<float, R, 4> result;
+
+      for (std::size_t i = 0; i < R; ++i) {
+        float4 row = mul4(splat4(lhs.data[i][0]), b[0]);
+
+        for (std::size_t k = 1; k < K; ++k) {
+          row = madd4(splat4(lhs.data[i][k]), b[k], row);
+        }
+
+        store4(result.data[i], row);
+      }
+
+      return result;
+    }
+
+    template<std::size_t R>
+    vec<float, R> simd_mul(const mat<float, R, 4>& lhs, const vec4f& rhs) {
+      static_assert(R == 3 || R == 4, "R should be 3 or 4");
+
+      float4 v = load4(rhs.data);
+      float4 r0 = mul4(load4(lhs.data[0]), v);
+      float4 r1 = mul4(load4(lhs.data[1]), v);
+      float4 r2 = mul4(load4(lhs.data[2]), v);
+      float4 r3 = splat4(0.0f);
+
+      if constexpr (R == 4) {
+        r3 = mul4(load4(lhs.data[3]), v);
+      }
+
+      transpose4(r0, r1, r2, r3);
+
+      // the products are summed in the same order as the scalar code
+      float tmp[4];
+      store4(tmp, add4(add4(add4(r0, r1), r2), r3));
+
+      vec<float, R> result;
+
+      for (std::size_t i = 0; i < R; ++i) {
+        result.data[i] = tmp[i];
+      }
+
+      return result;
+    }
+
+#if defined(HMI_SIMD_SSE2)
+
+    // block-wise inversion: the matrix is split in four 2x2 blocks A, B, C, D
+    // (each held in a float4) and the inverse is built from 2x2 products of
+    // the blocks and their adjugates
+
+    #define HMI_SHUFFLE(p, q, i0, i1, i2, i3) _mm_shuffle_ps(p, q, _MM_SHUFFLE(i3, i2, i1, i0))
+
+    // A * B
+    inline __m128 mat2_mul(__m128 a, __m128 b) {
+      return _mm_add_ps(_mm_mul_ps(a, HMI_SHUFFLE(b, b, 0, 3, 0, 3)), _mm_mul_ps(HMI_SHUFFLE(a, a, 1, 0, 3, 2), HMI_SHUFFLE(b, b, 2, 1, 2, 1)));
+    }
+
+    // adj(A) * B
+    inline __m128 mat2_adj_mul(__m128 a, __m128 b) {
+      return _mm_sub_ps(_mm_mul_ps(HMI_SHUFFLE(a, a, 3, 3, 0, 0), b), _mm_mul_ps(HMI_SHUFFLE(a, a, 1, 1, 2, 2), HMI_SHUFFLE(b, b, 2, 3, 0, 1)));
+    }
+
+    // A * adj(B)
+    inline __m128 mat2_mul_adj(__m128 a, __m128 b) {
+      return _mm_sub_ps(_mm_mul_ps(a, HMI_SHUFFLE(b, b, 3, 0, 3, 0)), _mm_mul_ps(HMI_SHUFFLE(a, a, 1, 0, 3, 2), HMI_SHUFFLE(b, b, 2, 1, 2, 1)));
+    }
+
+    inline mat4f simd_invert(const mat4f& m) {
+      __m128 r0 = _mm_loadu_ps(m.data[0]);
+      __m128 r1 = _mm_loadu_ps(m.data[1]);
+      __m128 r2 = _mm_loadu_ps(m.data[2]);
+      __m128 r3 = _mm_loadu_ps(m.data[3]);
+
+      __m128 a = _mm_movelh_ps(r0, r1);
+      __m128 b = _mm_movehl_ps(r1, r0);
+      __m128 c = _mm_movelh_ps(r2, r3);
+      __m128 d = _mm_movehl_ps(r3, r2);
+
+      // determinants of the blocks: |A| |B| |C| |D|
+      __m128 dets = _mm_sub_ps(
+        _mm_mul_ps(HMI_SHUFFLE(r0, r2, 0, 2, 0, 2), HMI_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+        _mm_mul_ps(HMI_SHUFFLE(r0, r2, 1, 3, 1, 3), HMI_SHUFFLE(r1, r3, 0, 2, 0, 2))
+      );
+
+      __m128 det_a = HMI_SHUFFLE(dets, dets, 0, 0, 0, 0);
+      __m128 det_b = HMI_SHUFFLE(dets, dets, 1, 1, 1, 1);
+      __m128 det_c = HMI_SHUFFLE(dets, dets, 2, 2, 2, 2);
+      __m128 det_d = HMI_SHUFFLE(dets, dets, 3, 3, 3, 3);
+
+      __m128 d_c = mat2_adj_mul(d, c);
+      __m128 a_b = mat2_adj_mul(a, b);
+
+      __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), mat2_mul(b, d_c));
+      __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), mat2_mul(c, a_b));
+      __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), mat2_mul_adj(d, a_b));
+      __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), mat2_mul_adj(a, d_c));
+
+      // |M| = |A| |D| + |B| |C| - tr(adj(A) B adj(D) C)
+      __m128 tr = _mm_mul_ps(a_b, HMI_SHUFFLE(d_c, d_c, 0, 2, 1, 3));
+      tr = _mm_add_ps(tr, HMI_SHUFFLE(tr, tr, 2, 3, 0, 1));
+      tr = _mm_add_ps(tr, HMI_SHUFFLE(tr, tr, 1, 0, 3, 2));
+
+      __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+      __m128 inv_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+
+      x = _mm_mul_ps(x, inv_det);
+      y = _mm_mul_ps(y, inv_det);
+      z = _mm_mul_ps(z, inv_det);
+      w = _mm_mul_ps(w, inv_det);
+
+      // the adjugate of the blocks is applied by the shuffles
+      mat4f result;
+      _mm_storeu_ps(result.data[0], HMI_SHUFFLE(x, y, 3, 1, 3, 1));
+      _mm_storeu_ps(result.data[1], HMI_SHUFFLE(x, y, 2, 0, 2, 0));
+      _mm_storeu_ps(result.data[2], HMI_SHUFFLE(z, w, 3, 1, 3, 1));
+      _mm_storeu_ps(result.data[3], HMI_SHUFFLE(z, w, 2, 0, 2, 0));
+      return result;
+    }
+
+    #undef HMI_SHUFFLE
+
+#endif
+
+#endif
+
+  }
+
+}
+
+#endif // HMI_BITS_MAT_SIMD_H
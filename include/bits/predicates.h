@@ -0,0 +1,135 @@
+#ifndef HMI_BITS_PREDICATES_H
+#define HMI_BITS_PREDICATES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "box.h"
+#include "span.h"
+#include "vec.h"
+
+namespace hmi {
+
+  namespace detail {
+
+    // error bounds of the double evaluation (Shewchuk, stage A)
+    constexpr double PREDICATE_EPSILON = 0x1p-53;
+    constexpr double ORIENT2D_BOUND = (3.0 + 16.0 * PREDICATE_EPSILON) * PREDICATE_EPSILON;
+    constexpr double INCIRCLE_BOUND = (10.0 + 96.0 * PREDICATE_EPSILON) * PREDICATE_EPSILON;
+
+    // evaluation with floating-point expansions, only the sign is exact
+    double orient2d_exact(vec2d a, vec2d b, vec2d c);
+    double incircle_exact(vec2d a, vec2d b, vec2d c, vec2d d);
+
+  }
+
+  // positive if a, b and c are in counterclockwise order (with the y axis
+  // pointing up), negative if clockwise, zero if collinear; the sign is exact
+  // and the value approximates twice the area of the triangle
+
+  inline double orient2d(vec2d a, vec2d b, vec2d c) {
+    double left = (a[0] - c[0]) * (b[1] - c[1]);
+    double right = (a[1] - c[1]) * (b[0] - c[0]);
+    double det = left - right;
+    double sum;
+
+    // when the products have different signs, the sign of the difference is right
+    if (left > 0.0) {
+      if (right <= 0.0) {
+        return det;
+      }
+
+      sum = left + right;
+    } else if (left < 0.0) {
+      if (right >= 0.0) {
+        return det;
+      }
+
+      sum = - left - right;
+    } else {
+      return det;
+    }
+
+    if (det >= detail::ORIENT2D_BOUND * sum || - det >= detail::ORIENT2D_BOUND * sum) {
+      return det;
+    }
+
+    return detail::orient2d_exact(a, b, c);
+  }
+
+  // positive if d is inside the circle through a, b and c (in counterclockwise
+  // order), negative if outside, zero if on the circle; the sign is exact
+
+  inline double incircle(vec2d a, vec2d b, vec2d c, vec2d d) {
+    double adx = a[0] - d[0];
+    double ady = a[1] - d[1];
+    double bdx = b[0] - d[0];
+    double bdy = b[1] - d[1];
+    double cdx = c[0] - d[0];
+    double cdy = c[1] - d[1];
+
+    double bdxcdy = bdx * cdy;
+    double cdxbdy = cdx * bdy;
+    double alift = adx * adx + ady * ady;
+
+    double cdxady = cdx * ady;
+    double adxcdy = adx * cdy;
+    double blift = bdx * bdx + bdy * bdy;
+
+    double adxbdy = adx * bdy;
+    double bdxady = bdx * ady;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+
+    auto abs = [](double x) { return x < 0.0 ? -x : x; };
+    double permanent = (abs(bdxcdy) + abs(cdxbdy)) * alift + (abs(cdxady) + abs(adxcdy)) * blift + (abs(adxbdy) + abs(bdxady)) * clift;
+    double bound = detail::INCIRCLE_BOUND * permanent;
+
+    if (det > bound || - det > bound) {
+      return det;
+    }
+
+    return detail::incircle_exact(a, b, c, d);
+  }
+
+  // non-zero winding rule, the points on the boundary are inside
+
+  bool point_in_polygon(span<const vec2f> polygon, vec2f point);
+
+  // a polygon with a table of its edges, cut in horizontal bands: a test
+  // only looks at the edges that cross the band of the point
+
+  class prepared_polygon {
+  public:
+    explicit prepared_polygon(span<const vec2f> polygon);
+
+    const box2f& get_bounds() const {
+      return m_bounds;
+    }
+
+    bool contains(vec2f point) const;
+
+  private:
+    struct edge {
+      vec2f a;
+      vec2f b;
+    };
+
+    box2f m_bounds;
+    float m_band_scale;
+    std::vector<std::uint32_t> m_band_offsets;
+    std::vector<edge> m_band_edges;
+  };
+
+  // bulk queries, the indices of the matching points or polygons are
+  // appended to the result
+
+  void find_inside(span<const vec2f> polygon, span<const vec2f> points, std::vector<std::size_t>& result);
+
+  void find_containing(span<const prepared_polygon> polygons, vec2f point, std::vector<std::size_t>& result);
+
+}
+
+#endif // HMI_BITS_PREDICATES_H
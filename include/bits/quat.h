@@ -0,0 +1,290 @@
+#ifndef HMI_BITS_QUAT_H
+#define HMI_BITS_QUAT_H
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "mat.h"
+#include "simd.h"
+#include "vec.h"
+#include "vec_functions.h"
+#include "vec_ops.h"
+
+namespace hmi {
+
+  // quaternion x i + y j + z k + w, stored as a vec4 with w last (the
+  // components are accessed by index); a rotation is a unit quaternion
+
+  template<typename T>
+  struct quat {
+    T data[4];
+
+    quat() = default;
+
+    constexpr quat(T m1, T m2, T m3, T m4) noexcept
+    : data{ m1, m2, m3, m4 }
+    {
+
+    }
+
+    quat(const quat& other) = default;
+
+    template<typename U>
+    constexpr quat(const quat<U>& other) noexcept
+    : data{ static_cast<T>(other.data[0]), static_cast<T>(other.data[1]), static_cast<T>(other.data[2]), static_cast<T>(other.data[3]) }
+    {
+
+    }
+
+    static constexpr quat identity() noexcept {
+      return quat(T(0), T(0), T(0), T(1));
+    }
+
+    // the axis must be normalized, the angle is in radians
+    static quat from_axis_angle(vec<T, 3> axis, T angle) noexcept {
+      T s = std::sin(angle / T(2));
+      return quat(axis[0] * s, axis[1] * s, axis[2] * s, std::cos(angle / T(2)));
+    }
+
+    // the matrix must be a rotation (Shepperd's method)
+    static quat from_mat3(const mat<T, 3>& m) noexcept {
+      return from_rotation(m.data);
+    }
+
+    // the upper-left 3x3 block of the matrix must be a rotation
+    static quat from_mat4(const mat<T, 4>& m) noexcept {
+      return from_rotation(m.data);
+    }
+
+    constexpr T operator[](std::size_t i) const noexcept {
+      return data[i];
+    }
+
+    constexpr T& operator[](std::size_t i) noexcept {
+      return data[i];
+    }
+
+  private:
+    template<std::size_t C>
+    static quat from_rotation(const T (&m)[C][C]) noexcept {
+      T trace = m[0][0] + m[1][1] + m[2][2];
+
+      if (trace > T(0)) {
+        T s = std::sqrt(trace + T(1)) * T(2);
+        return quat((m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s, s / T(4));
+      }
+
+      // the largest diagonal element avoids the cancellation
+      if (m[0][0] > m[1][1] && m[0][0] > m[2][2]) {
+        T s = std::sqrt(T(1) + m[0][0] - m[1][1] - m[2][2]) * T(2);
+        return quat(s / T(4), (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s, (m[2][1] - m[1][2]) / s);
+      }
+
+      if (m[1][1] > m[2][2]) {
+        T s = std::sqrt(T(1) + m[1][1] - m[0][0] - m[2][2]) * T(2);
+        return quat((m[0][1] + m[1][0]) / s, s / T(4), (m[1][2] + m[2][1]) / s, (m[0][2] - m[2][0]) / s);
+      }
+
+      T s = std::sqrt(T(1) + m[2][2] - m[0][0] - m[1][1]) * T(2);
+      return quat((m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, s / T(4), (m[1][0] - m[0][1]) / s);
+    }
+  };
+
+  static_assert(detail::is_packed_v<quatf, float, 4> && detail::is_packed_v<quatd, double, 4>);
+
+  namespace detail {
+
+    template<typename T>
+    inline constexpr bool is_simd_quat_v = false;
+
+#if defined(HMI_SIMD_DISPATCH)
+
+    template<>
+    inline constexpr bool is_simd_quat_v<float> = true;
+
+    // rhs with its components permuted for the products by lhs.x, lhs.y and lhs.z
+
+    inline void permute_quat(float4 b, float4& bx, float4& by, float4& bz) {
+#if defined(HMI_SIMD_SSE2)
+      bx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3));
+      by = _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2));
+      bz = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+#else
+      by = vextq_f32(b, b, 2);
+      bx = vrev64q_f32(by);
+      bz = vrev64q_f32(b);
+#endif
+    }
+
+    // the product is lhs.w * rhs plus lhs.x, lhs.y and lhs.z times rhs with
+    // its components permuted and negated, like the rows of a mat4f product
+
+    inline quatf simd_mul(const quatf& lhs, const quatf& rhs) {
+      static const float signs_x[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+      static const float signs_y[4] = { 1.0f, 1.0f, -1.0f, -1.0f };
+      static const float signs_z[4] = { -1.0f, 1.0f, 1.0f, -1.0f };
+
+      float4 b = load4(rhs.data);
+      float4 bx, by, bz;
+      permute_quat(b, bx, by, bz);
+
+      float4 r = mul4(splat4(lhs.data[3]), b);
+      r = add4(r, mul4(splat4(lhs.data[0]), mul4(bx, load4(signs_x))));
+      r = add4(r, mul4(splat4(lhs.data[1]), mul4(by, load4(signs_y))));
+      r = add4(r, mul4(splat4(lhs.data[2]), mul4(bz, load4(signs_z))));
+
+      quatf result;
+      store4(result.data, r);
+      return result;
+    }
+
+#endif
+
+  }
+
+  template<typename T>
+  constexpr
+  bool operator==(const quat<T>& lhs, const quat<T>& rhs) noexcept {
+    return lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2] && lhs[3] == rhs[3];
+  }
+
+  template<typename T>
+  constexpr
+  bool operator!=(const quat<T>& lhs, const quat<T>& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  // Hamilton product, the rotation rhs is applied first
+
+  template<typename T>
+  constexpr
+  quat<T> operator*(const quat<T>& lhs, const quat<T>& rhs) noexcept {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_quat_v<T>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_mul(lhs, rhs);
+      }
+    }
+#endif
+
+    return quat<T>(
+      lhs[3] * rhs[0] + lhs[0] * rhs[3] + lhs[1] * rhs[2] - lhs[2] * rhs[1],
+      lhs[3] * rhs[1] - lhs[0] * rhs[2] + lhs[1] * rhs[3] + lhs[2] * rhs[0],
+      lhs[3] * rhs[2] + lhs[0] * rhs[1] - lhs[1] * rhs[0] + lhs[2] * rhs[3],
+      lhs[3] * rhs[3] - lhs[0] * rhs[0] - lhs[1] * rhs[1] - lhs[2] * rhs[2]
+    );
+  }
+
+  template<typename T>
+  constexpr
+  quat<T>& operator*=(quat<T>& lhs, const quat<T>& rhs) noexcept {
+    lhs = lhs * rhs;
+    return lhs;
+  }
+
+  // the inverse of a unit quaternion
+
+  template<typename T>
+  constexpr
+  quat<T> conjugate(const quat<T>& q) noexcept {
+    return quat<T>(- q[0], - q[1], - q[2], q[3]);
+  }
+
+  template<typename T>
+  constexpr
+  T dot(const quat<T>& lhs, const quat<T>& rhs) noexcept {
+    return lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2] + lhs[3] * rhs[3];
+  }
+
+  template<typename T>
+  quat<T> normalize(const quat<T>& q) noexcept {
+    T factor = T(1) / std::sqrt(dot(q, q));
+    return quat<T>(q[0] * factor, q[1] * factor, q[2] * factor, q[3] * factor);
+  }
+
+  // spherical interpolation on the shortest arc, t in [0, 1]; close
+  // rotations are interpolated linearly, where the sine is not accurate
+
+  template<typename T>
+  quat<T> slerp(const quat<T>& start, const quat<T>& end, T t) noexcept {
+    T cos_theta = dot(start, end);
+    T sign = T(1);
+
+    if (cos_theta < T(0)) {
+      cos_theta = - cos_theta;
+      sign = T(-1);
+    }
+
+    T start_weight = T(1) - t;
+    T end_weight = t;
+
+    if (cos_theta < T(0.9995)) {
+      T theta = std::acos(cos_theta);
+      T sin_theta = std::sin(theta);
+      start_weight = std::sin(start_weight * theta) / sin_theta;
+      end_weight = std::sin(end_weight * theta) / sin_theta;
+    }
+
+    end_weight *= sign;
+
+    quat<T> result(
+      start[0] * start_weight + end[0] * end_weight,
+      start[1] * start_weight + end[1] * end_weight,
+      start[2] * start_weight + end[2] * end_weight,
+      start[3] * start_weight + end[3] * end_weight
+    );
+
+    return normalize(result);
+  }
+
+  // v + 2 w (u x v) + 2 u x (u x v) with u the vector part, cheaper than
+  // q v q* and than the matrix
+
+  template<typename T>
+  constexpr
+  vec<T, 3> rotate(const quat<T>& q, vec<T, 3> v) noexcept {
+    vec<T, 3> u(q[0], q[1], q[2]);
+    vec<T, 3> t = cross(u, v) * T(2);
+    return v + t * q[3] + cross(u, t);
+  }
+
+  template<typename T>
+  constexpr
+  mat<T, 3> to_mat3(const quat<T>& q) noexcept {
+    T xx = q[0] * q[0];
+    T yy = q[1] * q[1];
+    T zz = q[2] * q[2];
+    T xy = q[0] * q[1];
+    T xz = q[0] * q[2];
+    T yz = q[1] * q[2];
+    T wx = q[3] * q[0];
+    T wy = q[3] * q[1];
+    T wz = q[3] * q[2];
+
+    return mat<T, 3>(
+      T(1) - T(2) * (yy + zz), T(2) * (xy - wz),        T(2) * (xz + wy),
+      T(2) * (xy + wz),        T(1) - T(2) * (xx + zz), T(2) * (yz - wx),
+      T(2) * (xz - wy),        T(2) * (yz + wx),        T(1) - T(2) * (xx + yy)
+    );
+  }
+
+  // the transformation of an object: scale first, then rotation, then
+  // translation; it is built directly, without any matrix product
+
+  template<typename T>
+  constexpr
+  mat<T, 4> to_mat4(const quat<T>& rotation, vec<T, 3> translation = vec<T, 3>(T(0), T(0), T(0)), vec<T, 3> scale = vec<T, 3>(T(1), T(1), T(1))) noexcept {
+    mat<T, 3> r = to_mat3(rotation);
+
+    return mat<T, 4>(
+      r(0, 0) * scale[0], r(0, 1) * scale[1], r(0, 2) * scale[2], translation[0],
+      r(1, 0) * scale[0], r(1, 1) * scale[1], r(1, 2) * scale[2], translation[1],
+      r(2, 0) * scale[0], r(2, 1) * scale[1], r(2, 2) * scale[2], translation[2],
+      T(0),               T(0),               T(0),               T(1)
+    );
+  }
+
+}
+
+#endif // HMI_BITS_QUAT_H
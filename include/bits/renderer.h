@@ -2,13 +2,19 @@
 #define HMI_BITS_RENDERER_H
 
 #include <cstdint>
+#include <vector>
 
+#include "geometry_fwd.h"
+#include "span.h"
 #include "vec.h"
-#include "mat.h"
 
 struct SDL_Window; // implementation detail
 
 namespace hmi {
+  class heatmap;
+  class tilemap;
+  class trace_buffer;
+  class video_surface;
   class window;
 
   class renderer {
@@ -35,6 +41,11 @@ namespace hmi {
 
     vec2f get_coords_from_position(vec2i position);
 
+    // true if the window has an sRGB framebuffer, see window_flags::srgb
+    bool is_srgb() const {
+      return m_srgb;
+    }
+
     void clear(color4f color);
 
     void fill_rectangle(vec2f coords, vec2f size, color4f color);
@@ -45,6 +56,19 @@ namespace hmi {
 
     void draw_circle(vec2f center, float radius, color4f color);
 
+    void draw_line_strip(span<const vec2f> points, color4f color, float width = 1.0f);
+
+    // fixed-point coordinates, sent to OpenGL ES as GL_FIXED
+    void draw_line_strip(span<const vec2x> points, color4f color, float width = 1.0f);
+
+    void draw_trace(const trace_buffer& trace, color4f color, float width = 1.0f);
+
+    void draw_heatmap(const heatmap& map, vec2f coords, vec2f size);
+
+    void draw_tilemap(tilemap& map, vec2f coords, vec2f tile_size);
+
+    void draw_video(video_surface& surface, vec2f coords, vec2f size);
+
     void display();
 
 
@@ -54,8 +78,15 @@ namespace hmi {
       color4f color;
     };
 
-    mat3f get_view_matrix() const;
+    color4f get_output_color(color4f color) const;
+    box2f get_view_box() const;
+    transform2f get_view_transform() const;
+    bool prepare_draw(uint32_t program);
     void draw(const vertex *vertices, std::size_t count, int primitive);
+    void draw(const vec2f *positions, std::size_t count, color4f color, int primitive);
+    void draw(const vec2x *positions, std::size_t count, color4f color, int primitive);
+    void draw_positions(const void *positions, int type, std::size_t count, color4f color, int primitive);
+    void draw_textured(uint32_t program, span<const uint32_t> textures, vec2f coords, vec2f size, vec2f tex_size);
 
   private:
     friend class window;
@@ -68,6 +99,14 @@ namespace hmi {
     vec2f m_view_size;
 
     uint32_t m_program;
+    uint32_t m_heatmap_program;
+    uint32_t m_tilemap_program;
+    uint32_t m_video_program;
+
+    bool m_srgb;
+
+    std::vector<vec2f> m_line_buffer;
+    std::vector<vec2x> m_fixed_line_buffer;
   };
 
 }
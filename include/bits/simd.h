@@ -0,0 +1,181 @@
+#ifndef HMI_BITS_SIMD_H
+#define HMI_BITS_SIMD_H
+
+// Detection of the SIMD instruction sets available at compile time.
+// Define HMI_NO_SIMD to force the scalar code paths.
+
+#if !defined(HMI_NO_SIMD)
+  #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HMI_SIMD_SSE2 1
+    #include <emmintrin.h>
+  #endif
+
+  #if defined(__AVX__)
+    #define HMI_SIMD_AVX 1
+    #include <immintrin.h>
+  #endif
+
+  #if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define HMI_SIMD_F16C 1
+    #include <immintrin.h>
+  #endif
+
+  #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define HMI_SIMD_NEON 1
+    #include <arm_neon.h>
+    #include <cmath>
+  #endif
+#endif
+
+// The SIMD code paths of the constexpr operators are only taken outside of
+// constant evaluation, so they need a way to detect it.
+
+#if defined(__has_builtin)
+  #if __has_builtin(__builtin_is_constant_evaluated)
+    #define HMI_HAS_IS_CONSTANT_EVALUATED 1
+  #endif
+#endif
+
+#if !defined(HMI_HAS_IS_CONSTANT_EVALUATED)
+  #if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+    #define HMI_HAS_IS_CONSTANT_EVALUATED 1
+  #endif
+#endif
+
+#if (defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)) && defined(HMI_HAS_IS_CONSTANT_EVALUATED)
+  #define HMI_SIMD_DISPATCH 1
+#endif
+
+namespace hmi {
+
+  namespace detail {
+
+    constexpr bool is_constant_evaluated() noexcept {
+#if defined(HMI_HAS_IS_CONSTANT_EVALUATED)
+      return __builtin_is_constant_evaluated();
+#else
+      return true; // stay on the constexpr code paths
+#endif
+    }
+
+#if defined(HMI_SIMD_SSE2)
+
+    using float4 = __m128;
+
+    inline float4 load4(const float *p) { return _mm_loadu_ps(p); }
+    inline void store4(float *p, float4 v) { _mm_storeu_ps(p, v); }
+    inline float4 splat4(float x) { return _mm_set1_ps(x); }
+
+    inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+    inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+    inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+    inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+    inline float4 madd4(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    inline float4 sqrt4(float4 a) { return _mm_sqrt_ps(a); }
+
+    // reciprocal square root refined by a Newton-Raphson step, relative error below 1e-6
+    inline float4 rsqrt4(float4 a) {
+      float4 y = _mm_rsqrt_ps(a);
+      float4 ayy = _mm_mul_ps(_mm_mul_ps(a, y), y);
+      return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), y), _mm_sub_ps(_mm_set1_ps(3.0f), ayy));
+    }
+
+    inline void transpose4(float4& r0, float4& r1, float4& r2, float4& r3) {
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+
+    // comparisons give all bits set in the lanes where they are true
+    inline float4 cmple4(float4 a, float4 b) { return _mm_cmple_ps(a, b); }
+    inline float4 and4(float4 a, float4 b) { return _mm_and_ps(a, b); }
+
+    // one bit per lane, lane 0 in the least significant bit
+    inline int mask4(float4 m) { return _mm_movemask_ps(m); }
+
+#elif defined(HMI_SIMD_NEON)
+
+    using float4 = float32x4_t;
+
+    inline float4 load4(const float *p) { return vld1q_f32(p); }
+    inline void store4(float *p, float4 v) { vst1q_f32(p, v); }
+    inline float4 splat4(float x) { return vdupq_n_f32(x); }
+
+    inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+    inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+    inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+    // not vmlaq_f32, which may be fused and round differently from the scalar code
+    inline float4 madd4(float4 a, float4 b, float4 c) { return vaddq_f32(vmulq_f32(a, b), c); }
+
+    // the estimate only has 8 bits, so two Newton-Raphson steps are needed
+    inline float4 rsqrt4(float4 a) {
+      float32x4_t y = vrsqrteq_f32(a);
+      y = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, y), y), y);
+      y = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, y), y), y);
+      return y;
+    }
+
+    inline float4 sqrt4(float4 a) {
+#if defined(__aarch64__)
+      return vsqrtq_f32(a);
+#else
+      // ARMv7 only has an estimate, which is not correctly rounded
+      float lanes[4];
+      vst1q_f32(lanes, a);
+
+      for (float& lane : lanes) {
+        lane = std::sqrt(lane);
+      }
+
+      return vld1q_f32(lanes);
+#endif
+    }
+
+    inline float4 div4(float4 a, float4 b) {
+#if defined(__aarch64__)
+      return vdivq_f32(a, b);
+#else
+      // same as sqrt4, the reciprocal estimate is not correctly rounded
+      float lhs[4], rhs[4];
+      vst1q_f32(lhs, a);
+      vst1q_f32(rhs, b);
+
+      for (int k = 0; k < 4; ++k) {
+        lhs[k] /= rhs[k];
+      }
+
+      return vld1q_f32(lhs);
+#endif
+    }
+
+    inline void transpose4(float4& r0, float4& r1, float4& r2, float4& r3) {
+      float32x4x2_t t01 = vtrnq_f32(r0, r1);
+      float32x4x2_t t23 = vtrnq_f32(r2, r3);
+      r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+      r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+      r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+      r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    inline float4 cmple4(float4 a, float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+
+    inline float4 and4(float4 a, float4 b) {
+      return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+    }
+
+    inline int mask4(float4 m) {
+      static const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+      uint32x4_t bits = vandq_u32(vreinterpretq_u32_f32(m), vld1q_u32(lane_bits));
+#if defined(__aarch64__)
+      return static_cast<int>(vaddvq_u32(bits));
+#else
+      uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+      return static_cast<int>(vget_lane_u32(vpadd_u32(sum, sum), 0));
+#endif
+    }
+
+#endif
+
+  }
+
+}
+
+#endif // HMI_BITS_SIMD_H
@@ -0,0 +1,106 @@
+#ifndef HMI_BITS_SPAN_H
+#define HMI_BITS_SPAN_H
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace hmi {
+
+  // a subset of std::span (C++20) with a dynamic extent
+
+  template<typename T>
+  class span {
+  public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+
+    constexpr span() noexcept
+    : m_data(nullptr)
+    , m_size(0)
+    {
+
+    }
+
+    constexpr span(T *data, std::size_t size) noexcept
+    : m_data(data)
+    , m_size(size)
+    {
+
+    }
+
+    template<std::size_t N>
+    constexpr span(T (&array)[N]) noexcept
+    : m_data(array)
+    , m_size(N)
+    {
+
+    }
+
+    template<typename Container, typename = std::enable_if_t<
+      std::is_convertible_v<decltype(std::declval<Container&>().data()), T*> &&
+      (std::is_const_v<T> || std::is_lvalue_reference_v<Container>)
+    >>
+    constexpr span(Container&& container) noexcept
+    : m_data(container.data())
+    , m_size(container.size())
+    {
+
+    }
+
+    span(const span& other) = default;
+    span& operator=(const span& other) = default;
+
+    constexpr T *data() const noexcept {
+      return m_data;
+    }
+
+    constexpr std::size_t size() const noexcept {
+      return m_size;
+    }
+
+    constexpr bool empty() const noexcept {
+      return m_size == 0;
+    }
+
+    constexpr T& operator[](std::size_t i) const noexcept {
+      assert(i < m_size);
+      return m_data[i];
+    }
+
+    constexpr T *begin() const noexcept {
+      return m_data;
+    }
+
+    constexpr T *end() const noexcept {
+      return m_data + m_size;
+    }
+
+    constexpr span first(std::size_t count) const noexcept {
+      assert(count <= m_size);
+      return span(m_data, count);
+    }
+
+    constexpr span last(std::size_t count) const noexcept {
+      assert(count <= m_size);
+      return span(m_data + m_size - count, count);
+    }
+
+    constexpr span subspan(std::size_t offset, std::size_t count) const noexcept {
+      assert(offset + count <= m_size);
+      return span(m_data + offset, count);
+    }
+
+  private:
+    T *m_data;
+    std::size_t m_size;
+  };
+
+} // namespace hmi
+
+#endif // HMI_BITS_SPAN_H
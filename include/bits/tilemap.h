@@ -0,0 +1,59 @@
+#ifndef HMI_BITS_TILEMAP_H
+#define HMI_BITS_TILEMAP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "span.h"
+#include "vec.h"
+
+namespace hmi {
+  class renderer;
+
+  class tilemap {
+  public:
+    static constexpr int chunk_size = 64;
+
+    tilemap(vec2i size, span<const color4f> palette);
+    ~tilemap();
+
+    tilemap(const tilemap&) = delete;
+    tilemap& operator=(const tilemap&) = delete;
+
+    vec2i get_size() const {
+      return m_size;
+    }
+
+    void set_palette(span<const color4f> palette);
+
+    void set_tile(vec2i position, std::uint8_t index);
+
+    std::uint8_t get_tile(vec2i position) const;
+
+    void fill(std::uint8_t index);
+
+  private:
+    struct chunk {
+      uint32_t texture;
+      bool dirty;
+      std::uint8_t tiles[chunk_size * chunk_size];
+    };
+
+    vec2i get_chunk_count() const {
+      return m_chunk_count;
+    }
+
+    uint32_t get_chunk_texture(vec2i position);
+
+  private:
+    friend class renderer;
+
+    vec2i m_size;
+    vec2i m_chunk_count;
+    uint32_t m_palette_texture;
+    std::vector<chunk> m_chunks;
+  };
+
+}
+
+#endif // HMI_BITS_TILEMAP_H
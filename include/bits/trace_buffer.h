@@ -0,0 +1,64 @@
+#ifndef HMI_BITS_TRACE_BUFFER_H
+#define HMI_BITS_TRACE_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "span.h"
+#include "vec.h"
+
+namespace hmi {
+
+  class trace_buffer {
+  public:
+    trace_buffer(std::size_t capacity, float origin = 0.0f, float step = 1.0f);
+
+    std::size_t get_capacity() const {
+      return m_samples.size();
+    }
+
+    std::size_t get_size() const;
+
+    float get_origin() const {
+      return m_origin;
+    }
+
+    float get_step() const {
+      return m_step;
+    }
+
+    float get_first_x() const;
+
+    float get_last_x() const;
+
+    void clear();
+
+    void append(float value);
+
+    void append(span<const float> values);
+
+    void decimate(float left, float right, std::size_t columns, std::vector<vec2f>& result) const;
+
+  private:
+    struct range {
+      float min;
+      float max;
+    };
+
+    std::uint64_t get_first_index() const;
+    float get_x(std::uint64_t index) const;
+    float get_sample(std::uint64_t index) const;
+    range get_range(std::uint64_t begin, std::uint64_t end) const;
+
+  private:
+    float m_origin;
+    float m_step;
+    std::uint64_t m_count;
+    std::vector<float> m_samples;
+    std::vector<std::vector<range>> m_levels;
+  };
+
+}
+
+#endif // HMI_BITS_TRACE_BUFFER_H
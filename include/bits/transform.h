@@ -0,0 +1,161 @@
+#ifndef HMI_BITS_TRANSFORM_H
+#define HMI_BITS_TRANSFORM_H
+
+#include <cmath>
+#include <cstddef>
+
+#include "mat.h"
+#include "span.h"
+#include "vec.h"
+#include "vec_functions.h"
+
+namespace hmi {
+
+  // affine transformations, the last row of the matrix is ignored
+
+  template<typename T>
+  constexpr
+  vec<T, 2> transform_point(const mat<T, 3>& m, vec<T, 2> point) noexcept {
+    return {
+      m(0, 0) * point[0] + m(0, 1) * point[1] + m(0, 2),
+      m(1, 0) * point[0] + m(1, 1) * point[1] + m(1, 2)
+    };
+  }
+
+  template<typename T>
+  constexpr
+  vec<T, 3> transform_point(const mat<T, 4>& m, vec<T, 3> point) noexcept {
+    return {
+      m(0, 0) * point[0] + m(0, 1) * point[1] + m(0, 2) * point[2] + m(0, 3),
+      m(1, 0) * point[0] + m(1, 1) * point[1] + m(1, 2) * point[2] + m(1, 3),
+      m(2, 0) * point[0] + m(2, 1) * point[1] + m(2, 2) * point[2] + m(2, 3)
+    };
+  }
+
+  // the same transformations without the constant last row
+
+  template<typename T>
+  constexpr
+  vec<T, 2> transform_point(const mat<T, 2, 3>& m, vec<T, 2> point) noexcept {
+    return {
+      m(0, 0) * point[0] + m(0, 1) * point[1] + m(0, 2),
+      m(1, 0) * point[0] + m(1, 1) * point[1] + m(1, 2)
+    };
+  }
+
+  template<typename T>
+  constexpr
+  vec<T, 3> transform_point(const mat<T, 3, 4>& m, vec<T, 3> point) noexcept {
+    return {
+      m(0, 0) * point[0] + m(0, 1) * point[1] + m(0, 2) * point[2] + m(0, 3),
+      m(1, 0) * point[0] + m(1, 1) * point[1] + m(1, 2) * point[2] + m(1, 3),
+      m(2, 0) * point[0] + m(2, 1) * point[1] + m(2, 2) * point[2] + m(2, 3)
+    };
+  }
+
+  // 2D affine transformations are mat2x3 (transform2), with the constant
+  // last row implied: the composition and the inverse skip it
+
+  template<typename T>
+  constexpr
+  mat<T, 2, 3> operator*(const mat<T, 2, 3>& lhs, const mat<T, 2, 3>& rhs) noexcept {
+    return mat<T, 2, 3>(
+      lhs(0, 0) * rhs(0, 0) + lhs(0, 1) * rhs(1, 0),
+      lhs(0, 0) * rhs(0, 1) + lhs(0, 1) * rhs(1, 1),
+      lhs(0, 0) * rhs(0, 2) + lhs(0, 1) * rhs(1, 2) + lhs(0, 2),
+      lhs(1, 0) * rhs(0, 0) + lhs(1, 1) * rhs(1, 0),
+      lhs(1, 0) * rhs(0, 1) + lhs(1, 1) * rhs(1, 1),
+      lhs(1, 0) * rhs(0, 2) + lhs(1, 1) * rhs(1, 2) + lhs(1, 2)
+    );
+  }
+
+  template<typename T>
+  constexpr
+  mat<T, 2, 3>& operator*=(mat<T, 2, 3>& lhs, const mat<T, 2, 3>& rhs) noexcept {
+    lhs = lhs * rhs;
+    return lhs;
+  }
+
+  template<typename T>
+  constexpr
+  mat<T, 2, 3> invert(const mat<T, 2, 3>& input) noexcept {
+    T det = input(0, 0) * input(1, 1) - input(1, 0) * input(0, 1);
+
+    T xx = input(1, 1) / det;
+    T xy = - input(0, 1) / det;
+    T yx = - input(1, 0) / det;
+    T yy = input(0, 0) / det;
+
+    return mat<T, 2, 3>(
+      xx, xy, - (xx * input(0, 2) + xy * input(1, 2)),
+      yx, yy, - (yx * input(0, 2) + yy * input(1, 2))
+    );
+  }
+
+  // vectors are not affected by the translation
+
+  template<typename T>
+  constexpr
+  vec<T, 2> transform_vector(const mat<T, 2, 3>& t, vec<T, 2> vector) noexcept {
+    return {
+      t(0, 0) * vector[0] + t(0, 1) * vector[1],
+      t(1, 0) * vector[0] + t(1, 1) * vector[1]
+    };
+  }
+
+  template<typename T>
+  constexpr
+  mat<T, 3> to_mat3(const mat<T, 2, 3>& t) noexcept {
+    return mat<T, 3>(
+      t(0, 0), t(0, 1), t(0, 2),
+      t(1, 0), t(1, 1), t(1, 2),
+      T(0),    T(0),    T(1)
+    );
+  }
+
+  // the view matrix of a camera at eye looking at target, with OpenGL
+  // conventions: the camera looks along -z and y is up on the screen
+
+  template<typename T>
+  mat<T, 4> look_at(vec<T, 3> eye, vec<T, 3> target, vec<T, 3> up) noexcept {
+    vec<T, 3> f = normalize(target - eye);
+    vec<T, 3> s = normalize(cross(f, up));
+    vec<T, 3> u = cross(s, f);
+
+    return mat<T, 4>(
+      s[0],    s[1],    s[2],    - dot(s, eye),
+      u[0],    u[1],    u[2],    - dot(u, eye),
+      - f[0],  - f[1],  - f[2],  dot(f, eye),
+      T(0),    T(0),    T(0),    T(1)
+    );
+  }
+
+  // the projection of a vertical field of view in radians, with OpenGL
+  // conventions: the visible z goes from -z_near to -z_far and is mapped to [-1, 1]
+
+  template<typename T>
+  mat<T, 4> perspective(T fovy, T aspect, T z_near, T z_far) noexcept {
+    T f = T(1) / std::tan(fovy / T(2));
+    T depth = z_near - z_far;
+
+    return mat<T, 4>(
+      f / aspect, T(0), T(0),                     T(0),
+      T(0),       f,    T(0),                     T(0),
+      T(0),       T(0), (z_far + z_near) / depth, T(2) * z_far * z_near / depth,
+      T(0),       T(0), T(-1),                    T(0)
+    );
+  }
+
+  // in and out must have the same size, they may be the same span but must not partially overlap
+
+  void transform_points(const mat3f& m, span<const vec2f> in, span<vec2f> out);
+
+  void transform_points(const mat4f& m, span<const vec3f> in, span<vec3f> out);
+
+  inline void transform_points(const mat2x3f& t, span<const vec2f> in, span<vec2f> out) {
+    transform_points(to_mat3(t), in, out);
+  }
+
+}
+
+#endif // HMI_BITS_TRANSFORM_H
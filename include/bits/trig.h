@@ -0,0 +1,75 @@
+#ifndef HMI_BITS_TRIG_H
+#define HMI_BITS_TRIG_H
+
+#include <cassert>
+#include <cstddef>
+
+#include "span.h"
+
+namespace hmi {
+
+  namespace detail {
+
+    // pi/2 split in three parts so that k * pi/2 is computed exactly for
+    // small values of k (Cody-Waite reduction)
+    constexpr float TRIG_2_OVER_PI = 0.636619772367581343f;
+    constexpr float TRIG_PI_2_A = 1.5703125f;
+    constexpr float TRIG_PI_2_B = 4.837512969970703125e-4f;
+    constexpr float TRIG_PI_2_C = 7.54978995489188216e-8f;
+
+    // minimax polynomials on [-pi/4, pi/4]
+    constexpr float TRIG_SIN_1 = -1.6666654611e-1f;
+    constexpr float TRIG_SIN_2 = 8.3321608736e-3f;
+    constexpr float TRIG_SIN_3 = -1.9515295891e-4f;
+    constexpr float TRIG_COS_1 = 4.166664568298827e-2f;
+    constexpr float TRIG_COS_2 = -1.388731625493765e-3f;
+    constexpr float TRIG_COS_3 = 2.443315711809948e-5f;
+
+  }
+
+  // sine and cosine of the same angle (in radians) with an absolute error
+  // below 1e-6 for |angle| <= 8192, far below a pixel for any radius that
+  // fits on a screen; the angle must be in this range (so neither NaN nor
+  // infinite), otherwise the conversion of k to int overflows
+
+  constexpr void fast_sincos(float angle, float& sin, float& cos) noexcept {
+    using namespace detail;
+
+    assert(angle >= -8192.0f && angle <= 8192.0f);
+
+    // angle = k * pi/2 + r with |r| <= pi/4, rounded half away from zero
+    float scaled = angle * TRIG_2_OVER_PI;
+    int k = static_cast<int>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+    float kf = static_cast<float>(k);
+    float r = ((angle - kf * TRIG_PI_2_A) - kf * TRIG_PI_2_B) - kf * TRIG_PI_2_C;
+    float r2 = r * r;
+
+    float s = r + r * r2 * (TRIG_SIN_1 + r2 * (TRIG_SIN_2 + r2 * TRIG_SIN_3));
+    float c = 1.0f - 0.5f * r2 + r2 * r2 * (TRIG_COS_1 + r2 * (TRIG_COS_2 + r2 * TRIG_COS_3));
+
+    switch (k & 3) {
+      case 0:
+        sin = s;
+        cos = c;
+        break;
+      case 1:
+        sin = c;
+        cos = -s;
+        break;
+      case 2:
+        sin = -s;
+        cos = -c;
+        break;
+      default:
+        sin = -c;
+        cos = s;
+        break;
+    }
+  }
+
+  // the same computation, 4 angles at a time with SSE2 or NEON
+  void fast_sincos(span<const float> angles, span<float> sines, span<float> cosines);
+
+}
+
+#endif // HMI_BITS_TRIG_H
@@ -2,15 +2,18 @@
 #define HMI_BITS_VEC_H
 
 #include <cstddef>
-#include <initializer_list>
+#include <type_traits>
+
+#include "geometry_fwd.h"
 
 namespace hmi {
 
-  template<typename T, std::size_t N, std::size_t Index>
-  struct vec_accessor {
-    static_assert(Index < N, "Index should be less than N");
+  // the accessor of a component only depends on its type and its index, so
+  // the accessors are shared by all the vectors and matrices of the same type
 
-    T data[N];
+  template<typename T, std::size_t Index>
+  struct vec_accessor {
+    T data[Index + 1];
 
     constexpr operator T() const noexcept {
       return data[Index];
@@ -46,13 +49,13 @@ namespace hmi {
   struct vec {
     T data[N];
 
-    vec() {
-    }
+    vec() = default;
 
     vec(const vec& other) = default;
 
     template<typename U>
-    vec(const vec<U, N>& other) noexcept
+    constexpr vec(const vec<U, N>& other) noexcept
+    : data{}
     {
       for (std::size_t i = 0; i < N; ++i) {
         data[i] = static_cast<T>(other.data[i]);
@@ -73,15 +76,14 @@ namespace hmi {
     union {
       T data[2];
 
-      vec_accessor<T, 2, 0> x;
-      vec_accessor<T, 2, 1> y;
+      vec_accessor<T, 0> x;
+      vec_accessor<T, 1> y;
 
-      vec_accessor<T, 2, 0> width;
-      vec_accessor<T, 2, 1> height;
+      vec_accessor<T, 0> width;
+      vec_accessor<T, 1> height;
     };
 
-    vec() {
-    }
+    vec() = default;
 
     constexpr vec(T m1, T m2) noexcept
     : data{ m1, m2 }
@@ -92,7 +94,7 @@ namespace hmi {
     vec(const vec& other) = default;
 
     template<typename U>
-    vec(const vec<U, 2>& other) noexcept
+    constexpr vec(const vec<U, 2>& other) noexcept
     : data{ static_cast<T>(other[0]), static_cast<T>(other[1]) }
     {
 
@@ -113,17 +115,16 @@ namespace hmi {
     union {
       T data[3];
 
-      vec_accessor<T, 3, 0> x;
-      vec_accessor<T, 3, 1> y;
-      vec_accessor<T, 3, 1> z;
+      vec_accessor<T, 0> x;
+      vec_accessor<T, 1> y;
+      vec_accessor<T, 2> z;
 
-      vec_accessor<T, 3, 0> r;
-      vec_accessor<T, 3, 1> g;
-      vec_accessor<T, 3, 1> b;
+      vec_accessor<T, 0> r;
+      vec_accessor<T, 1> g;
+      vec_accessor<T, 2> b;
     };
 
-    vec() {
-    }
+    vec() = default;
 
     constexpr vec(T m1, T m2, T m3) noexcept
     : data{ m1, m2, m3 }
@@ -134,7 +135,9 @@ namespace hmi {
     vec(const vec& other) = default;
 
     template<typename U>
-    vec(const vec<U, 3>& other) noexcept {
+    constexpr vec(const vec<U, 3>& other) noexcept
+    : data{}
+    {
       for (std::size_t i = 0; i < 3; ++i) {
         data[i] = static_cast<T>(other.data[i]);
       }
@@ -154,19 +157,18 @@ namespace hmi {
     union {
       T data[4];
 
-      vec_accessor<T, 4, 0> x;
-      vec_accessor<T, 4, 1> y;
-      vec_accessor<T, 4, 1> z;
-      vec_accessor<T, 4, 1> w;
+      vec_accessor<T, 0> x;
+      vec_accessor<T, 1> y;
+      vec_accessor<T, 2> z;
+      vec_accessor<T, 3> w;
 
-      vec_accessor<T, 4, 0> r;
-      vec_accessor<T, 4, 1> g;
-      vec_accessor<T, 4, 1> b;
-      vec_accessor<T, 4, 1> a;
+      vec_accessor<T, 0> r;
+      vec_accessor<T, 1> g;
+      vec_accessor<T, 2> b;
+      vec_accessor<T, 3> a;
     };
 
-    vec() {
-    }
+    vec() = default;
 
     constexpr vec(T m1, T m2, T m3, T m4) noexcept
     : data{ m1, m2, m3, m4 }
@@ -177,7 +179,8 @@ namespace hmi {
     vec(const vec& other) = default;
 
     template<typename U>
-    vec(const vec<U, 4>& other) noexcept
+    constexpr vec(const vec<U, 4>& other) noexcept
+    : data{}
     {
       for (std::size_t i = 0; i < 4; ++i) {
         data[i] = static_cast<T>(other.data[i]);
@@ -193,40 +196,37 @@ namespace hmi {
     }
   };
 
+  // a vector aligned on 16 bytes, so that it fills whole SIMD registers and
+  // never straddles a cache line; it converts to and from the packed vector
 
-  template<typename T>
-  using vec2 = vec<T, 2>;
-
-  using vec2f = vec2<float>;
-
-  using vec2d = vec2<double>;
-
-  using vec2i = vec2<int>;
-
-
-  template<typename T>
-  using vec3 = vec<T, 3>;
-
-  using vec3f = vec3<float>;
-
-  using vec3d = vec3<double>;
+  template<typename T, std::size_t N>
+  struct alignas(16) aligned_vec : vec<T, N> {
+    using vec<T, N>::vec;
 
-  using vec3i = vec3<int>;
+    aligned_vec() = default;
 
+    constexpr aligned_vec(const vec<T, N>& other) noexcept
+    : vec<T, N>(other)
+    {
 
-  template<typename T>
-  using vec4 = vec<T, 4>;
+    }
+  };
 
-  using vec4f = vec4<float>;
+  namespace detail {
 
-  using vec4d = vec4<double>;
+    // a packed type can be copied with memcpy and uploaded as an array of T
 
-  using vec4i = vec4<int>;
+    template<typename V, typename T, std::size_t N>
+    constexpr bool is_packed_v = std::is_trivial_v<V> && std::is_standard_layout_v<V> && sizeof(V) == N * sizeof(T) && alignof(V) == alignof(T);
 
+  }
 
-  using color3f = vec3f;
+  static_assert(detail::is_packed_v<vec2f, float, 2> && detail::is_packed_v<vec2d, double, 2> && detail::is_packed_v<vec2i, int, 2>);
+  static_assert(detail::is_packed_v<vec3f, float, 3> && detail::is_packed_v<vec3d, double, 3> && detail::is_packed_v<vec3i, int, 3>);
+  static_assert(detail::is_packed_v<vec4f, float, 4> && detail::is_packed_v<vec4d, double, 4> && detail::is_packed_v<vec4i, int, 4>);
 
-  using color4f = vec4f;
+  static_assert(std::is_trivial_v<vec4f_a> && std::is_standard_layout_v<vec4f_a> && sizeof(vec4f_a) == 16 && alignof(vec4f_a) == 16);
+  static_assert(std::is_trivial_v<vec3f_a> && std::is_standard_layout_v<vec3f_a> && sizeof(vec3f_a) == 16 && alignof(vec3f_a) == 16);
 
 } // namespace hmi
 
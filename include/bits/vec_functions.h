@@ -0,0 +1,160 @@
+#ifndef HMI_BITS_VEC_FUNCTIONS_H
+#define HMI_BITS_VEC_FUNCTIONS_H
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "simd.h"
+#include "span.h"
+#include "vec.h"
+#include "vec_ops.h"
+#include "vec_simd.h"
+
+namespace hmi {
+
+  namespace detail {
+
+    // approximation of 1 / sqrt(x), see rsqrt4 for the error bound
+    inline float fast_rsqrt(float x) noexcept {
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+      float result[4];
+      store4(result, rsqrt4(splat4(x)));
+      return result[0];
+#else
+      return 1.0f / std::sqrt(x);
+#endif
+    }
+
+    inline double fast_rsqrt(double x) noexcept {
+      return 1.0 / std::sqrt(x);
+    }
+
+  }
+
+  template<typename T, typename U, std::size_t N>
+  constexpr
+  std::common_type_t<T,U> dot(vec<T,N> lhs, vec<U,N> rhs) noexcept {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_dot(lhs, rhs);
+      }
+    }
+#endif
+
+    std::common_type_t<T,U> result = lhs[0] * rhs[0];
+
+    for (std::size_t i = 1; i < N; ++i) {
+      result += lhs[i] * rhs[i];
+    }
+
+    return result;
+  }
+
+  template<typename T, typename U>
+  constexpr
+  vec<std::common_type_t<T,U>,3> cross(vec<T,3> lhs, vec<U,3> rhs) noexcept {
+    return {
+      lhs[1] * rhs[2] - lhs[2] * rhs[1],
+      lhs[2] * rhs[0] - lhs[0] * rhs[2],
+      lhs[0] * rhs[1] - lhs[1] * rhs[0]
+    };
+  }
+
+  // z component of the cross product of the two vectors extended with z = 0
+
+  template<typename T, typename U>
+  constexpr
+  std::common_type_t<T,U> cross(vec<T,2> lhs, vec<U,2> rhs) noexcept {
+    return lhs[0] * rhs[1] - lhs[1] * rhs[0];
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  T length_squared(vec<T,N> v) noexcept {
+    return dot(v, v);
+  }
+
+  template<typename T, std::size_t N>
+  auto length(vec<T,N> v) noexcept {
+    return std::sqrt(length_squared(v));
+  }
+
+  template<typename T, typename U, std::size_t N>
+  auto distance(vec<T,N> lhs, vec<U,N> rhs) noexcept {
+    return length(lhs - rhs);
+  }
+
+  // the length of the vector must not be zero
+
+  template<typename T, std::size_t N>
+  vec<T,N> normalize(vec<T,N> v) noexcept {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, T, N>) {
+      return detail::simd_div(v, length(v));
+    }
+#endif
+
+    return v / length(v);
+  }
+
+  template<typename T, typename U, typename V, std::size_t N>
+  constexpr
+  vec<std::common_type_t<T,U,V>,N> lerp(vec<T,N> lhs, vec<U,N> rhs, V t) noexcept {
+    return lhs + (rhs - lhs) * t;
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  vec<T,N> clamp(vec<T,N> v, vec<T,N> lo, vec<T,N> hi) noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      v[i] = v[i] < lo[i] ? lo[i] : (hi[i] < v[i] ? hi[i] : v[i]);
+    }
+
+    return v;
+  }
+
+  template<typename T, std::size_t N>
+  constexpr
+  vec<T,N> clamp(vec<T,N> v, T lo, T hi) noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      v[i] = v[i] < lo ? lo : (hi < v[i] ? hi : v[i]);
+    }
+
+    return v;
+  }
+
+  // approximate variants, the relative error is below 1e-6 for float
+
+  template<typename T, std::size_t N>
+  T fast_length(vec<T,N> v) noexcept {
+    static_assert(std::is_floating_point_v<T>, "T should be a floating point type");
+    T squared = length_squared(v);
+    return squared == T(0) ? T(0) : squared * detail::fast_rsqrt(squared);
+  }
+
+  template<typename T, typename U, std::size_t N>
+  auto fast_distance(vec<T,N> lhs, vec<U,N> rhs) noexcept {
+    return fast_length(lhs - rhs);
+  }
+
+  template<typename T, std::size_t N>
+  vec<T,N> fast_normalize(vec<T,N> v) noexcept {
+    static_assert(std::is_floating_point_v<T>, "T should be a floating point type");
+    return v * detail::fast_rsqrt(length_squared(v));
+  }
+
+  // bulk forms, in and out must have the same size and may be the same span
+
+  void normalize(span<const vec2f> in, span<vec2f> out);
+
+  void normalize(span<const vec3f> in, span<vec3f> out);
+
+  void fast_normalize(span<const vec2f> in, span<vec2f> out);
+
+  void fast_normalize(span<const vec3f> in, span<vec3f> out);
+
+}
+
+#endif // HMI_BITS_VEC_FUNCTIONS_H
@@ -4,10 +4,12 @@
 #include <type_traits>
 
 #include "vec.h"
+#include "vec_simd.h"
 
 namespace hmi {
 
   template<typename T, std::size_t N>
+  constexpr
   bool operator==(vec<T, N> lhs, vec<T, N> rhs) {
     for (std::size_t i = 0; i < N; ++i) {
       if (lhs[i] != rhs[i]) {
@@ -19,13 +21,15 @@ namespace hmi {
   }
 
   template<typename T, std::size_t N>
+  constexpr
   bool operator!=(vec<T, N> lhs, vec<T, N> rhs) {
     return !(lhs == rhs);
   }
 
   template<typename T, std::size_t N>
+  constexpr
   vec<T, N> operator-(vec<T, N> v) {
-    vec<T, N> result;
+    vec<T, N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = - v[i];
@@ -39,7 +43,15 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator+(vec<T,N> lhs, vec<U,N> rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_add(lhs, rhs);
+      }
+    }
+#endif
+
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs[i] + rhs[i];
@@ -51,6 +63,14 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<T,N>& operator+=(vec<T,N>& lhs, vec<U,N> rhs) noexcept {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return lhs = detail::simd_add(lhs, rhs);
+      }
+    }
+#endif
+
     for (std::size_t i = 0; i < N; ++i) {
       lhs[i] += rhs[i];
     }
@@ -61,7 +81,7 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator+(T lhs, vec<U,N> rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs + rhs[i];
@@ -73,7 +93,7 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator+(vec<T,N> lhs, U rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs[i] + rhs;
@@ -98,7 +118,15 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator-(vec<T,N> lhs, vec<U,N> rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_sub(lhs, rhs);
+      }
+    }
+#endif
+
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs[i] - rhs[i];
@@ -110,6 +138,14 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<T,N>& operator-=(vec<T,N>& lhs, vec<U,N> rhs) noexcept {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return lhs = detail::simd_sub(lhs, rhs);
+      }
+    }
+#endif
+
     for (std::size_t i = 0; i < N; ++i) {
       lhs[i] -= rhs[i];
     }
@@ -120,7 +156,7 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator-(T lhs, vec<U,N> rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs - rhs[i];
@@ -132,7 +168,7 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator-(vec<T,N> lhs, U rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs[i] - rhs;
@@ -157,7 +193,15 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator*(vec<T,N> lhs, vec<U,N> rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_mul(lhs, rhs);
+      }
+    }
+#endif
+
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs[i] * rhs[i];
@@ -169,6 +213,14 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<T,N>& operator*=(vec<T,N>& lhs, vec<U,N> rhs) noexcept {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return lhs = detail::simd_mul(lhs, rhs);
+      }
+    }
+#endif
+
     for (std::size_t i = 0; i < N; ++i) {
       lhs[i] *= rhs[i];
     }
@@ -179,7 +231,15 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator*(T lhs, vec<U,N> rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_scale(rhs, lhs);
+      }
+    }
+#endif
+
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs * rhs[i];
@@ -191,7 +251,15 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator*(vec<T,N> lhs, U rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return detail::simd_scale(lhs, rhs);
+      }
+    }
+#endif
+
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs[i] * rhs;
@@ -203,6 +271,14 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<T,N>& operator*=(vec<T,N>& lhs, U rhs) noexcept {
+#if defined(HMI_SIMD_DISPATCH)
+    if constexpr (detail::is_simd_vec_v<T, U, N>) {
+      if (!detail::is_constant_evaluated()) {
+        return lhs = detail::simd_scale(lhs, rhs);
+      }
+    }
+#endif
+
     for (std::size_t i = 0; i < N; ++i) {
       lhs[i] *= rhs;
     }
@@ -216,7 +292,7 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator/(vec<T,N> lhs, vec<U,N> rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs[i] / rhs[i];
@@ -238,7 +314,7 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator/(T lhs, vec<U,N> rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs / rhs[i];
@@ -250,7 +326,7 @@ namespace hmi {
   template<typename T, typename U, std::size_t N>
   constexpr
   vec<std::common_type_t<T,U>,N> operator/(vec<T,N> lhs, U rhs) noexcept {
-    vec<std::common_type_t<T,U>,N> result;
+    vec<std::common_type_t<T,U>,N> result{};
 
     for (std::size_t i = 0; i < N; ++i) {
       result[i] = lhs[i] / rhs;
@@ -0,0 +1,64 @@
+#ifndef HMI_BITS_VEC_SIMD_H
+#define HMI_BITS_VEC_SIMD_H
+
+#include <cstddef>
+
+#include "simd.h"
+#include "vec.h"
+
+namespace hmi {
+
+  namespace detail {
+
+    template<typename T, typename U, std::size_t N>
+    inline constexpr bool is_simd_vec_v = false;
+
+#if defined(HMI_SIMD_DISPATCH)
+
+    template<>
+    inline constexpr bool is_simd_vec_v<float, float, 4> = true;
+
+    inline vec4f simd_add(const vec4f& lhs, const vec4f& rhs) {
+      vec4f result;
+      store4(result.data, add4(load4(lhs.data), load4(rhs.data)));
+      return result;
+    }
+
+    inline vec4f simd_sub(const vec4f& lhs, const vec4f& rhs) {
+      vec4f result;
+      store4(result.data, sub4(load4(lhs.data), load4(rhs.data)));
+      return result;
+    }
+
+    inline vec4f simd_mul(const vec4f& lhs, const vec4f& rhs) {
+      vec4f result;
+      store4(result.data, mul4(load4(lhs.data), load4(rhs.data)));
+      return result;
+    }
+
+    inline vec4f simd_scale(const vec4f& lhs, float rhs) {
+      vec4f result;
+      store4(result.data, mul4(load4(lhs.data), splat4(rhs)));
+      return result;
+    }
+
+    // the products are summed in the same order as the scalar code
+    inline float simd_dot(const vec4f& lhs, const vec4f& rhs) {
+      float products[4];
+      store4(products, mul4(load4(lhs.data), load4(rhs.data)));
+      return ((products[0] + products[1]) + products[2]) + products[3];
+    }
+
+    inline vec4f simd_div(const vec4f& lhs, float rhs) {
+      vec4f result;
+      store4(result.data, div4(load4(lhs.data), splat4(rhs)));
+      return result;
+    }
+
+#endif
+
+  }
+
+}
+
+#endif // HMI_BITS_VEC_SIMD_H
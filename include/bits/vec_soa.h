@@ -0,0 +1,316 @@
+#ifndef HMI_BITS_VEC_SOA_H
+#define HMI_BITS_VEC_SOA_H
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "span.h"
+#include "vec.h"
+
+namespace hmi {
+
+  namespace detail {
+
+    enum class soa_op {
+      add,
+      sub,
+      mul,
+      div,
+    };
+
+    template<typename T>
+    constexpr T soa_apply_one(soa_op op, T lhs, T rhs) noexcept {
+      switch (op) {
+        case soa_op::add:
+          return lhs + rhs;
+        case soa_op::sub:
+          return lhs - rhs;
+        case soa_op::mul:
+          return lhs * rhs;
+        case soa_op::div:
+          return lhs / rhs;
+      }
+
+      return lhs;
+    }
+
+    template<typename T>
+    void soa_apply(soa_op op, T *out, const T *lhs, const T *rhs, std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i) {
+        out[i] = soa_apply_one(op, lhs[i], rhs[i]);
+      }
+    }
+
+    template<typename T>
+    void soa_apply(soa_op op, T *out, const T *lhs, T rhs, std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i) {
+        out[i] = soa_apply_one(op, lhs[i], rhs);
+      }
+    }
+
+    // SIMD kernels, see src/geometry.cc
+
+    void soa_apply(soa_op op, float *out, const float *lhs, const float *rhs, std::size_t count);
+    void soa_apply(soa_op op, float *out, const float *lhs, float rhs, std::size_t count);
+    void soa_interleave(const float *x, const float *y, vec2f *out, std::size_t count);
+    void soa_deinterleave(const vec2f *in, float *x, float *y, std::size_t count);
+
+  }
+
+  // a sequence of vectors where each component is stored contiguously
+
+  template<typename T, std::size_t N>
+  class vec_soa {
+  public:
+    class reference {
+    public:
+      operator vec<T, N>() const noexcept {
+        return static_cast<const vec_soa&>(*m_soa)[m_index];
+      }
+
+      reference& operator=(const vec<T, N>& value) noexcept {
+        for (std::size_t c = 0; c < N; ++c) {
+          m_soa->m_components[c][m_index] = value[c];
+        }
+
+        return *this;
+      }
+
+      reference& operator=(const reference& other) noexcept {
+        return *this = static_cast<vec<T, N>>(other);
+      }
+
+      T& operator[](std::size_t c) const noexcept {
+        return m_soa->m_components[c][m_index];
+      }
+
+    private:
+      friend class vec_soa;
+
+      reference(vec_soa *soa, std::size_t index)
+      : m_soa(soa)
+      , m_index(index)
+      {
+
+      }
+
+      vec_soa *m_soa;
+      std::size_t m_index;
+    };
+
+    vec_soa() = default;
+
+    explicit vec_soa(std::size_t size)
+    {
+      resize(size);
+    }
+
+    vec_soa(span<const vec<T, N>> values)
+    {
+      assign(values);
+    }
+
+    std::size_t size() const noexcept {
+      return m_components[0].size();
+    }
+
+    bool empty() const noexcept {
+      return m_components[0].empty();
+    }
+
+    void resize(std::size_t size) {
+      for (auto& component : m_components) {
+        component.resize(size, T(0));
+      }
+    }
+
+    void reserve(std::size_t capacity) {
+      for (auto& component : m_components) {
+        component.reserve(capacity);
+      }
+    }
+
+    void clear() noexcept {
+      for (auto& component : m_components) {
+        component.clear();
+      }
+    }
+
+    void push_back(const vec<T, N>& value) {
+      for (std::size_t c = 0; c < N; ++c) {
+        m_components[c].push_back(value[c]);
+      }
+    }
+
+    vec<T, N> operator[](std::size_t i) const noexcept {
+      assert(i < size());
+      vec<T, N> result;
+
+      for (std::size_t c = 0; c < N; ++c) {
+        result[c] = m_components[c][i];
+      }
+
+      return result;
+    }
+
+    reference operator[](std::size_t i) noexcept {
+      assert(i < size());
+      return reference(this, i);
+    }
+
+    span<T> component(std::size_t c) noexcept {
+      assert(c < N);
+      return m_components[c];
+    }
+
+    span<const T> component(std::size_t c) const noexcept {
+      assert(c < N);
+      return m_components[c];
+    }
+
+    // conversions from and to the interleaved layout of vec<T, N>
+
+    void assign(span<const vec<T, N>> values) {
+      resize(values.size());
+
+      if constexpr (std::is_same_v<T, float> && N == 2) {
+        detail::soa_deinterleave(values.data(), m_components[0].data(), m_components[1].data(), values.size());
+      } else {
+        for (std::size_t i = 0; i < values.size(); ++i) {
+          for (std::size_t c = 0; c < N; ++c) {
+            m_components[c][i] = values[i][c];
+          }
+        }
+      }
+    }
+
+    void interleave(span<vec<T, N>> out) const {
+      assert(out.size() == size());
+
+      if constexpr (std::is_same_v<T, float> && N == 2) {
+        detail::soa_interleave(m_components[0].data(), m_components[1].data(), out.data(), out.size());
+      } else {
+        for (std::size_t i = 0; i < out.size(); ++i) {
+          for (std::size_t c = 0; c < N; ++c) {
+            out[i][c] = m_components[c][i];
+          }
+        }
+      }
+    }
+
+    void interleave(std::vector<vec<T, N>>& result) const {
+      result.resize(size());
+      interleave(span<vec<T, N>>(result));
+    }
+
+    // element-wise operations
+
+    vec_soa& operator+=(const vec_soa& other) {
+      return apply(detail::soa_op::add, other);
+    }
+
+    vec_soa& operator-=(const vec_soa& other) {
+      return apply(detail::soa_op::sub, other);
+    }
+
+    vec_soa& operator*=(const vec_soa& other) {
+      return apply(detail::soa_op::mul, other);
+    }
+
+    vec_soa& operator/=(const vec_soa& other) {
+      return apply(detail::soa_op::div, other);
+    }
+
+    vec_soa& operator+=(const vec<T, N>& other) {
+      return apply(detail::soa_op::add, other);
+    }
+
+    vec_soa& operator-=(const vec<T, N>& other) {
+      return apply(detail::soa_op::sub, other);
+    }
+
+    vec_soa& operator*=(const vec<T, N>& other) {
+      return apply(detail::soa_op::mul, other);
+    }
+
+    vec_soa& operator/=(const vec<T, N>& other) {
+      return apply(detail::soa_op::div, other);
+    }
+
+    vec_soa& operator+=(T other) {
+      return apply(detail::soa_op::add, other);
+    }
+
+    vec_soa& operator-=(T other) {
+      return apply(detail::soa_op::sub, other);
+    }
+
+    vec_soa& operator*=(T other) {
+      return apply(detail::soa_op::mul, other);
+    }
+
+    vec_soa& operator/=(T other) {
+      return apply(detail::soa_op::div, other);
+    }
+
+  private:
+    vec_soa& apply(detail::soa_op op, const vec_soa& other) {
+      assert(size() == other.size());
+
+      for (std::size_t c = 0; c < N; ++c) {
+        detail::soa_apply(op, m_components[c].data(), m_components[c].data(), other.m_components[c].data(), size());
+      }
+
+      return *this;
+    }
+
+    vec_soa& apply(detail::soa_op op, const vec<T, N>& other) {
+      for (std::size_t c = 0; c < N; ++c) {
+        detail::soa_apply(op, m_components[c].data(), m_components[c].data(), other[c], size());
+      }
+
+      return *this;
+    }
+
+    vec_soa& apply(detail::soa_op op, T other) {
+      for (std::size_t c = 0; c < N; ++c) {
+        detail::soa_apply(op, m_components[c].data(), m_components[c].data(), other, size());
+      }
+
+      return *this;
+    }
+
+  private:
+    std::vector<T> m_components[N];
+  };
+
+  template<typename T, std::size_t N, typename U>
+  vec_soa<T, N> operator+(vec_soa<T, N> lhs, const U& rhs) {
+    return lhs += rhs;
+  }
+
+  template<typename T, std::size_t N, typename U>
+  vec_soa<T, N> operator-(vec_soa<T, N> lhs, const U& rhs) {
+    return lhs -= rhs;
+  }
+
+  template<typename T, std::size_t N, typename U>
+  vec_soa<T, N> operator*(vec_soa<T, N> lhs, const U& rhs) {
+    return lhs *= rhs;
+  }
+
+  template<typename T, std::size_t N, typename U>
+  vec_soa<T, N> operator/(vec_soa<T, N> lhs, const U& rhs) {
+    return lhs /= rhs;
+  }
+
+  template<typename T, std::size_t N>
+  vec_soa<T, N> operator*(T lhs, vec_soa<T, N> rhs) {
+    return rhs *= lhs;
+  }
+
+}
+
+#endif // HMI_BITS_VEC_SOA_H
@@ -0,0 +1,76 @@
+#ifndef HMI_BITS_VIDEO_SURFACE_H
+#define HMI_BITS_VIDEO_SURFACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "span.h"
+#include "vec.h"
+
+namespace hmi {
+  class renderer;
+
+  enum class video_format {
+    i420, // Y plane, U plane, V plane
+    nv12, // Y plane, interleaved UV plane
+  };
+
+  class video_surface {
+  public:
+    video_surface(vec2i size, video_format format);
+    ~video_surface();
+
+    video_surface(const video_surface&) = delete;
+    video_surface& operator=(const video_surface&) = delete;
+
+    vec2i get_size() const {
+      return m_size;
+    }
+
+    vec2i get_chroma_size() const {
+      return { (m_size.width + 1) / 2, (m_size.height + 1) / 2 };
+    }
+
+    video_format get_format() const {
+      return m_format;
+    }
+
+    // producer side, may be called from another thread than the renderer
+
+    void submit(span<const std::uint8_t> y, span<const std::uint8_t> u, span<const std::uint8_t> v);
+
+    void submit(span<const std::uint8_t> y, span<const std::uint8_t> uv);
+
+  private:
+    struct planes {
+      uint32_t y;
+      uint32_t u;
+      uint32_t v;
+    };
+
+    void publish();
+    const planes& get_planes();
+
+  private:
+    friend class renderer;
+
+    static constexpr unsigned FRESH = 0b100;
+
+    vec2i m_size;
+    video_format m_format;
+
+    // triple buffering of the frames between the producer and the renderer
+    std::vector<std::uint8_t> m_frames[3];
+    std::atomic<unsigned> m_shared;
+    unsigned m_produced;
+    unsigned m_consumed;
+
+    // double buffering of the textures
+    planes m_planes[2];
+    unsigned m_current;
+  };
+
+}
+
+#endif // HMI_BITS_VIDEO_SURFACE_H
@@ -21,6 +21,7 @@ namespace hmi {
     visible     = 0b0010,
     decorated   = 0b0100,
     fullscreen  = 0b1000,
+    srgb        = 0b10000, // only a hint at creation, see renderer::is_srgb()
   };
 
   constexpr window_flags operator&(window_flags lhs, window_flags rhs) {
@@ -0,0 +1,410 @@
+#include <bits/color.h>
+#include <bits/half.h>
+#include <bits/vec_ops.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#include <bits/simd.h>
+
+namespace hmi {
+
+  namespace {
+
+    static_assert(sizeof(half) == 2, "half should be 16 bits");
+    static_assert(sizeof(color4u8) == 4, "color4u8 should be made of 4 packed bytes");
+    static_assert(sizeof(color4h) == 8, "color4h should be made of 4 packed halfs");
+
+    static_assert(to_color4u8(color4f(1.0f, 0.5f, 0.0f, 2.0f)) == color4u8(255, 128, 0, 255));
+    static_assert(to_color4f(color4u8(255, 0, 0, 255)) == color::red);
+    static_assert(premultiply(color4f(1.0f, 0.5f, 0.0f, 0.5f)) == color4f(0.5f, 0.25f, 0.0f, 0.5f));
+    static_assert(unpremultiply(color4f(0.5f, 0.25f, 0.0f, 0.5f)) == color4f(1.0f, 0.5f, 0.0f, 0.5f));
+    static_assert(premultiply(color4u8(255, 128, 0, 128)) == color4u8(128, 64, 0, 128));
+    static_assert(unpremultiply(color4u8(128, 64, 0, 128)) == color4u8(255, 128, 0, 128));
+
+    constexpr int SRGB_TABLE_SIZE = 4096;
+
+    struct srgb_tables {
+      float linear[256];
+      std::uint8_t srgb[SRGB_TABLE_SIZE];
+
+      srgb_tables() {
+        for (int i = 0; i < 256; ++i) {
+          linear[i] = to_linear(i / 255.0f);
+        }
+
+        for (int i = 0; i < SRGB_TABLE_SIZE; ++i) {
+          srgb[i] = static_cast<std::uint8_t>(to_srgb(i / float(SRGB_TABLE_SIZE - 1)) * 255.0f + 0.5f);
+        }
+      }
+    };
+
+    const srgb_tables& get_srgb_tables() {
+      static const srgb_tables tables;
+      return tables;
+    }
+
+    // index in the sRGB table, clamped like to_color4u8
+    int srgb_index(float linear) {
+      float value = linear > 0.0f ? linear : 0.0f;
+      value = value < 1.0f ? value : 1.0f;
+      return static_cast<int>(value * (SRGB_TABLE_SIZE - 1) + 0.5f);
+    }
+
+#if defined(HMI_SIMD_SSE2) && !defined(HMI_SIMD_F16C)
+    // the software conversions of half.h, 4 values at a time
+
+    __m128i float_to_half4(__m128 value) {
+      const __m128i sign_mask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+      const __m128i denormal_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+
+      __m128i bits = _mm_castps_si128(value);
+      __m128i sign = _mm_and_si128(bits, sign_mask);
+      bits = _mm_xor_si128(bits, sign);
+
+      // the comparisons are signed, which is fine for the absolute value
+      __m128i overflow = _mm_cmpgt_epi32(bits, _mm_set1_epi32(((127 + 16) << 23) - 1));
+      __m128i nan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(255 << 23));
+      __m128i denormal = _mm_cmplt_epi32(bits, _mm_set1_epi32(113 << 23));
+
+      __m128i special = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(nan, _mm_set1_epi32(0x0200)));
+
+      __m128 shifted = _mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(denormal_magic));
+      __m128i small = _mm_sub_epi32(_mm_castps_si128(shifted), denormal_magic);
+
+      __m128i odd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+      __m128i normal = _mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(static_cast<int>(((15u - 127u) << 23) + 0xFFFu))), odd);
+      normal = _mm_srli_epi32(normal, 13);
+
+      __m128i result = _mm_or_si128(_mm_and_si128(denormal, small), _mm_andnot_si128(denormal, normal));
+      result = _mm_or_si128(_mm_and_si128(overflow, special), _mm_andnot_si128(overflow, result));
+      return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+    }
+
+    __m128 half_to_float4(__m128i value) {
+      const __m128i shifted_exponent = _mm_set1_epi32(0x7C00 << 13);
+      const __m128 denormal_magic = _mm_castsi128_ps(_mm_set1_epi32(113 << 23));
+
+      __m128i bits = _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x7FFF)), 13);
+      __m128i exponent = _mm_and_si128(bits, shifted_exponent);
+      bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+      __m128i special = _mm_cmpeq_epi32(exponent, shifted_exponent);
+      bits = _mm_add_epi32(bits, _mm_and_si128(special, _mm_set1_epi32((128 - 16) << 23)));
+
+      __m128i denormal = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+      __m128 renormalized = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))), denormal_magic);
+      bits = _mm_or_si128(_mm_and_si128(denormal, _mm_castps_si128(renormalized)), _mm_andnot_si128(denormal, bits));
+
+      bits = _mm_or_si128(bits, _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x8000)), 16));
+      return _mm_castsi128_ps(bits);
+    }
+#endif
+
+  }
+
+  void convert(span<const half> in, span<float> out) {
+    assert(in.size() == out.size());
+
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_F16C)
+    for (; i + 8 <= count; i += 8) {
+      __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in.data() + i));
+      _mm256_storeu_ps(out.data() + i, _mm256_cvtph_ps(h));
+    }
+#elif defined(HMI_SIMD_SSE2)
+    for (; i + 4 <= count; i += 4) {
+      __m128i h = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in.data() + i));
+      _mm_storeu_ps(out.data() + i, half_to_float4(_mm_unpacklo_epi16(h, _mm_setzero_si128())));
+    }
+#elif defined(HMI_SIMD_NEON) && defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+      float16x4_t h = vreinterpret_f16_u16(vld1_u16(&in[i].bits));
+      vst1q_f32(out.data() + i, vcvt_f32_f16(h));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      out[i] = in[i];
+    }
+  }
+
+  void convert(span<const float> in, span<half> out) {
+    assert(in.size() == out.size());
+
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_F16C)
+    for (; i + 8 <= count; i += 8) {
+      __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in.data() + i), _MM_FROUND_TO_NEAREST_INT);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out.data() + i), h);
+    }
+#elif defined(HMI_SIMD_SSE2)
+    for (; i + 4 <= count; i += 4) {
+      __m128i h = float_to_half4(_mm_loadu_ps(in.data() + i));
+      // sign extension so that the signed saturation keeps the 16 bits
+      h = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(out.data() + i), _mm_packs_epi32(h, h));
+    }
+#elif defined(HMI_SIMD_NEON) && defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+      float16x4_t h = vcvt_f16_f32(vld1q_f32(in.data() + i));
+      vst1_u16(&out[i].bits, vreinterpret_u16_f16(h));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      out[i] = half(in[i]);
+    }
+  }
+
+  void convert(span<const color4u8> in, span<color4f> out) {
+    assert(in.size() == out.size());
+
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+    const __m128 max = _mm_set1_ps(255.0f);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4) {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in[i].data));
+      __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+      __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+      _mm_storeu_ps(out[i].data, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), max));
+      _mm_storeu_ps(out[i + 1].data, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), max));
+      _mm_storeu_ps(out[i + 2].data, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), max));
+      _mm_storeu_ps(out[i + 3].data, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), max));
+    }
+#elif defined(HMI_SIMD_NEON)
+    const float32x4_t max = vdupq_n_f32(255.0f);
+
+    for (; i + 4 <= count; i += 4) {
+      uint8x16_t bytes = vld1q_u8(in[i].data);
+      uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+      uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+
+      vst1q_f32(out[i].data, detail::div4(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), max));
+      vst1q_f32(out[i + 1].data, detail::div4(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), max));
+      vst1q_f32(out[i + 2].data, detail::div4(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), max));
+      vst1q_f32(out[i + 3].data, detail::div4(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), max));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      out[i] = to_color4f(in[i]);
+    }
+  }
+
+  void convert(span<const color4f> in, span<color4u8> out) {
+    assert(in.size() == out.size());
+
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 max = _mm_set1_ps(255.0f);
+    const __m128 rounding = _mm_set1_ps(0.5f);
+
+    // max(x, 0) gives 0 for NaN, like to_color4u8
+    auto scale = [&](const float *p) {
+      __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(p), zero), one);
+      return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, max), rounding));
+    };
+
+    for (; i + 4 <= count; i += 4) {
+      __m128i lo = _mm_packs_epi32(scale(in[i].data), scale(in[i + 1].data));
+      __m128i hi = _mm_packs_epi32(scale(in[i + 2].data), scale(in[i + 3].data));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out[i].data), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(HMI_SIMD_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    auto scale = [&](const float *p) {
+      float32x4_t value = vld1q_f32(p);
+      value = vbslq_f32(vcgtq_f32(value, zero), value, zero);
+      value = vbslq_f32(vcltq_f32(value, one), value, one);
+      return vmovn_u32(vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(value, 255.0f), vdupq_n_f32(0.5f))));
+    };
+
+    for (; i + 4 <= count; i += 4) {
+      uint16x8_t lo = vcombine_u16(scale(in[i].data), scale(in[i + 1].data));
+      uint16x8_t hi = vcombine_u16(scale(in[i + 2].data), scale(in[i + 3].data));
+      vst1q_u8(out[i].data, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      out[i] = to_color4u8(in[i]);
+    }
+  }
+
+  void premultiply(span<color4f> colors) {
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+    using namespace detail;
+
+    for (; i + 4 <= colors.size(); i += 4) {
+      float4 r = load4(colors[i].data);
+      float4 g = load4(colors[i + 1].data);
+      float4 b = load4(colors[i + 2].data);
+      float4 a = load4(colors[i + 3].data);
+      transpose4(r, g, b, a);
+
+      r = mul4(r, a);
+      g = mul4(g, a);
+      b = mul4(b, a);
+
+      transpose4(r, g, b, a);
+      store4(colors[i].data, r);
+      store4(colors[i + 1].data, g);
+      store4(colors[i + 2].data, b);
+      store4(colors[i + 3].data, a);
+    }
+#endif
+
+    for (; i < colors.size(); ++i) {
+      colors[i] = premultiply(colors[i]);
+    }
+  }
+
+  void premultiply(span<color4u8> colors) {
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(128);
+    const __m128i alpha_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+    // 2 colors with 16 bits per component
+    auto multiply = [&](__m128i c) {
+      __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+      __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, a), rounding);
+      t = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+      return _mm_or_si128(_mm_and_si128(alpha_lanes, c), _mm_andnot_si128(alpha_lanes, t));
+    };
+
+    for (; i + 4 <= colors.size(); i += 4) {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(colors[i].data));
+      __m128i lo = multiply(_mm_unpacklo_epi8(bytes, zero));
+      __m128i hi = multiply(_mm_unpackhi_epi8(bytes, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(colors[i].data), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(HMI_SIMD_NEON)
+    // (t + ((t + 128) >> 8) + 128) >> 8, the same rounding as detail::mul_u8
+    auto multiply = [](uint8x8_t c, uint8x8_t a) {
+      uint16x8_t t = vmull_u8(c, a);
+      return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+    };
+
+    for (; i + 8 <= colors.size(); i += 8) {
+      uint8x8x4_t c = vld4_u8(colors[i].data);
+      c.val[0] = multiply(c.val[0], c.val[3]);
+      c.val[1] = multiply(c.val[1], c.val[3]);
+      c.val[2] = multiply(c.val[2], c.val[3]);
+      vst4_u8(colors[i].data, c);
+    }
+#endif
+
+    for (; i < colors.size(); ++i) {
+      colors[i] = premultiply(colors[i]);
+    }
+  }
+
+  float to_linear(float srgb) noexcept {
+    if (srgb <= 0.04045f) {
+      return srgb / 12.92f;
+    }
+
+    return std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+  }
+
+  float to_srgb(float linear) noexcept {
+    if (linear <= 0.0031308f) {
+      return linear * 12.92f;
+    }
+
+    return 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+  }
+
+  color4f to_linear(color4f srgb) noexcept {
+    return color4f(to_linear(srgb[0]), to_linear(srgb[1]), to_linear(srgb[2]), srgb[3]);
+  }
+
+  color4f to_srgb(color4f linear) noexcept {
+    return color4f(to_srgb(linear[0]), to_srgb(linear[1]), to_srgb(linear[2]), linear[3]);
+  }
+
+  color4f to_linear(color4u8 srgb) noexcept {
+    const srgb_tables& tables = get_srgb_tables();
+    return color4f(tables.linear[srgb[0]], tables.linear[srgb[1]], tables.linear[srgb[2]], srgb[3] / 255.0f);
+  }
+
+  color4u8 to_srgb8(color4f linear) noexcept {
+    const srgb_tables& tables = get_srgb_tables();
+    color4u8 result = to_color4u8(linear);
+
+    for (std::size_t i = 0; i < 3; ++i) {
+      result[i] = tables.srgb[srgb_index(linear[i])];
+    }
+
+    return result;
+  }
+
+  void to_linear(span<const color4u8> in, span<color4f> out) {
+    assert(in.size() == out.size());
+
+    const srgb_tables& tables = get_srgb_tables();
+
+    // no gather in SSE2 or NEON, the lookups are the whole work
+    for (std::size_t i = 0; i < in.size(); ++i) {
+      out[i] = color4f(tables.linear[in[i][0]], tables.linear[in[i][1]], tables.linear[in[i][2]], in[i][3] / 255.0f);
+    }
+  }
+
+  void to_srgb(span<const color4f> in, span<color4u8> out) {
+    assert(in.size() == out.size());
+
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+    const srgb_tables& tables = get_srgb_tables();
+
+    // the table indices of r, g, b and the alpha value, computed like srgb_index and to_color4u8
+    alignas(16) std::int32_t indices[4];
+
+    for (; i < count; ++i) {
+#if defined(HMI_SIMD_SSE2)
+      __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in[i].data), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+      __m128 scale = _mm_set_ps(255.0f, SRGB_TABLE_SIZE - 1, SRGB_TABLE_SIZE - 1, SRGB_TABLE_SIZE - 1);
+      _mm_store_si128(reinterpret_cast<__m128i *>(indices), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), _mm_set1_ps(0.5f))));
+#else
+      const float32x4_t zero = vdupq_n_f32(0.0f);
+      const float32x4_t one = vdupq_n_f32(1.0f);
+      static const float scales[4] = { SRGB_TABLE_SIZE - 1, SRGB_TABLE_SIZE - 1, SRGB_TABLE_SIZE - 1, 255.0f };
+      float32x4_t value = vld1q_f32(in[i].data);
+      value = vbslq_f32(vcgtq_f32(value, zero), value, zero);
+      value = vbslq_f32(vcltq_f32(value, one), value, one);
+      vst1q_s32(indices, vcvtq_s32_f32(vaddq_f32(vmulq_f32(value, vld1q_f32(scales)), vdupq_n_f32(0.5f))));
+#endif
+      out[i] = color4u8(tables.srgb[indices[0]], tables.srgb[indices[1]], tables.srgb[indices[2]], static_cast<std::uint8_t>(indices[3]));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      out[i] = to_srgb8(in[i]);
+    }
+  }
+
+}
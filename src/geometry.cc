@@ -0,0 +1,660 @@
+#include <bits/box.h>
+#include <bits/curve.h>
+#include <bits/transform.h>
+#include <bits/trig.h>
+#include <bits/vec_functions.h>
+#include <bits/vec_soa.h>
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <bits/simd.h>
+
+namespace hmi {
+
+  namespace {
+
+    // below this number of points, the transformation is done in the calling thread
+    constexpr std::size_t PARALLEL_THRESHOLD = 1 << 18;
+    constexpr std::size_t MAX_THREADS = 8;
+
+    template<typename Kernel, typename In, typename Out>
+    void run_in_parallel(Kernel kernel, const In *in, Out *out, std::size_t count) {
+      std::size_t thread_count = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), MAX_THREADS);
+      thread_count = std::min(thread_count, count / (PARALLEL_THRESHOLD / 2));
+
+      if (thread_count <= 1) {
+        kernel(in, out, count);
+        return;
+      }
+
+      std::size_t chunk = (count + thread_count - 1) / thread_count;
+      std::vector<std::thread> threads;
+
+      try {
+        for (std::size_t i = 1; i < thread_count; ++i) {
+          std::size_t begin = i * chunk;
+          std::size_t end = std::min(count, begin + chunk);
+          threads.emplace_back(kernel, in + begin, out + begin, end - begin);
+        }
+      } catch (...) {
+        // the threads already started must be joined before they are destroyed
+        for (auto& thread : threads) {
+          thread.join();
+        }
+
+        throw;
+      }
+
+      kernel(in, out, std::min(chunk, count));
+
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+
+#if defined(HMI_SIMD_SSE2)
+    #define HMI_SHUFFLE(p, q, i0, i1, i2, i3) _mm_shuffle_ps(p, q, _MM_SHUFFLE(i3, i2, i1, i0))
+
+    // deinterleave x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+    void load_points3(const float *p, __m128& x, __m128& y, __m128& z) {
+      __m128 a = _mm_loadu_ps(p);
+      __m128 b = _mm_loadu_ps(p + 4);
+      __m128 c = _mm_loadu_ps(p + 8);
+
+      __m128 t = HMI_SHUFFLE(b, c, 2, 3, 1, 2);
+      x = HMI_SHUFFLE(a, t, 0, 3, 0, 2);
+      y = HMI_SHUFFLE(HMI_SHUFFLE(a, b, 1, 1, 0, 0), t, 0, 2, 1, 3);
+      z = HMI_SHUFFLE(HMI_SHUFFLE(a, b, 2, 2, 1, 1), HMI_SHUFFLE(c, c, 0, 0, 3, 3), 0, 2, 0, 2);
+    }
+
+    void store_points3(float *q, __m128 x, __m128 y, __m128 z) {
+      __m128 xy_lo = _mm_unpacklo_ps(x, y);
+      __m128 xy_hi = _mm_unpackhi_ps(x, y);
+
+      _mm_storeu_ps(q, HMI_SHUFFLE(xy_lo, HMI_SHUFFLE(z, xy_lo, 0, 0, 2, 2), 0, 1, 0, 2));
+      _mm_storeu_ps(q + 4, HMI_SHUFFLE(HMI_SHUFFLE(xy_lo, z, 3, 3, 1, 1), xy_hi, 0, 2, 0, 1));
+      _mm_storeu_ps(q + 8, HMI_SHUFFLE(HMI_SHUFFLE(z, xy_hi, 2, 2, 2, 2), HMI_SHUFFLE(xy_hi, z, 3, 3, 3, 3), 0, 2, 0, 2));
+    }
+#endif
+
+    void transform_points_2d(const mat3f& m, const vec2f *in, vec2f *out, std::size_t count) {
+      std::size_t i = 0;
+
+#if defined(HMI_SIMD_AVX)
+      // 8 points at a time, the shuffles stay in 128-bit lanes so the order is restored by the unpacks
+      {
+        const __m256 xx = _mm256_set1_ps(m(0, 0)), xy = _mm256_set1_ps(m(0, 1)), xz = _mm256_set1_ps(m(0, 2));
+        const __m256 yx = _mm256_set1_ps(m(1, 0)), yy = _mm256_set1_ps(m(1, 1)), yz = _mm256_set1_ps(m(1, 2));
+
+        for (; i + 8 <= count; i += 8) {
+          __m256 a = _mm256_loadu_ps(in[i].data);
+          __m256 b = _mm256_loadu_ps(in[i + 4].data);
+          __m256 x = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+          __m256 y = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+          __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xx, x), _mm256_mul_ps(xy, y)), xz);
+          __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(yx, x), _mm256_mul_ps(yy, y)), yz);
+          _mm256_storeu_ps(out[i].data, _mm256_unpacklo_ps(rx, ry));
+          _mm256_storeu_ps(out[i + 4].data, _mm256_unpackhi_ps(rx, ry));
+        }
+      }
+#endif
+
+#if defined(HMI_SIMD_SSE2)
+      {
+        const __m128 xx = _mm_set1_ps(m(0, 0)), xy = _mm_set1_ps(m(0, 1)), xz = _mm_set1_ps(m(0, 2));
+        const __m128 yx = _mm_set1_ps(m(1, 0)), yy = _mm_set1_ps(m(1, 1)), yz = _mm_set1_ps(m(1, 2));
+
+        for (; i + 4 <= count; i += 4) {
+          __m128 a = _mm_loadu_ps(in[i].data);
+          __m128 b = _mm_loadu_ps(in[i + 2].data);
+          __m128 x = HMI_SHUFFLE(a, b, 0, 2, 0, 2);
+          __m128 y = HMI_SHUFFLE(a, b, 1, 3, 1, 3);
+          __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, x), _mm_mul_ps(xy, y)), xz);
+          __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(yx, x), _mm_mul_ps(yy, y)), yz);
+          _mm_storeu_ps(out[i].data, _mm_unpacklo_ps(rx, ry));
+          _mm_storeu_ps(out[i + 2].data, _mm_unpackhi_ps(rx, ry));
+        }
+      }
+#elif defined(HMI_SIMD_NEON)
+      {
+        for (; i + 4 <= count; i += 4) {
+          float32x4x2_t p = vld2q_f32(in[i].data);
+          float32x4x2_t r;
+          r.val[0] = vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], m(0, 0)), vmulq_n_f32(p.val[1], m(0, 1))), vdupq_n_f32(m(0, 2)));
+          r.val[1] = vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], m(1, 0)), vmulq_n_f32(p.val[1], m(1, 1))), vdupq_n_f32(m(1, 2)));
+          vst2q_f32(out[i].data, r);
+        }
+      }
+#endif
+
+      for (; i < count; ++i) {
+        out[i] = transform_point(m, in[i]);
+      }
+    }
+
+    void transform_points_3d(const mat4f& m, const vec3f *in, vec3f *out, std::size_t count) {
+      std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+      {
+        __m128 coeffs[3][4];
+
+        for (std::size_t row = 0; row < 3; ++row) {
+          for (std::size_t col = 0; col < 4; ++col) {
+            coeffs[row][col] = _mm_set1_ps(m(row, col));
+          }
+        }
+
+        for (; i + 4 <= count; i += 4) {
+          __m128 x, y, z;
+          load_points3(in[i].data, x, y, z);
+
+          __m128 r[3];
+
+          for (std::size_t row = 0; row < 3; ++row) {
+            __m128 v = _mm_add_ps(_mm_mul_ps(coeffs[row][0], x), _mm_mul_ps(coeffs[row][1], y));
+            r[row] = _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(coeffs[row][2], z)), coeffs[row][3]);
+          }
+
+          store_points3(out[i].data, r[0], r[1], r[2]);
+        }
+      }
+#elif defined(HMI_SIMD_NEON)
+      {
+        for (; i + 4 <= count; i += 4) {
+          float32x4x3_t p = vld3q_f32(in[i].data);
+          float32x4x3_t r;
+
+          for (std::size_t row = 0; row < 3; ++row) {
+            // the order of the scalar code, without fused multiply-add
+            float32x4_t v = vaddq_f32(vmulq_n_f32(p.val[0], m(row, 0)), vmulq_n_f32(p.val[1], m(row, 1)));
+            r.val[row] = vaddq_f32(vaddq_f32(v, vmulq_n_f32(p.val[2], m(row, 2))), vdupq_n_f32(m(row, 3)));
+          }
+
+          vst3q_f32(out[i].data, r);
+        }
+      }
+#endif
+
+      for (; i < count; ++i) {
+        out[i] = transform_point(m, in[i]);
+      }
+    }
+
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+    // normalizes 4 vectors given by their N components
+    template<bool Fast, std::size_t N>
+    void normalize4(detail::float4 (&c)[N]) {
+      using namespace detail;
+
+      float4 squared = mul4(c[0], c[0]);
+
+      for (std::size_t k = 1; k < N; ++k) {
+        squared = add4(squared, mul4(c[k], c[k]));
+      }
+
+      if constexpr (Fast) {
+        float4 factor = rsqrt4(squared);
+
+        for (std::size_t k = 0; k < N; ++k) {
+          c[k] = mul4(c[k], factor);
+        }
+      } else {
+        float4 length = sqrt4(squared);
+
+        for (std::size_t k = 0; k < N; ++k) {
+          c[k] = div4(c[k], length);
+        }
+      }
+    }
+#endif
+
+    template<bool Fast>
+    void normalize_2d(const vec2f *in, vec2f *out, std::size_t count) {
+      std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+      for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_loadu_ps(in[i].data);
+        __m128 b = _mm_loadu_ps(in[i + 2].data);
+        __m128 c[2] = { HMI_SHUFFLE(a, b, 0, 2, 0, 2), HMI_SHUFFLE(a, b, 1, 3, 1, 3) };
+        normalize4<Fast>(c);
+        _mm_storeu_ps(out[i].data, _mm_unpacklo_ps(c[0], c[1]));
+        _mm_storeu_ps(out[i + 2].data, _mm_unpackhi_ps(c[0], c[1]));
+      }
+#elif defined(HMI_SIMD_NEON)
+      for (; i + 4 <= count; i += 4) {
+        float32x4x2_t p = vld2q_f32(in[i].data);
+        normalize4<Fast>(p.val);
+        vst2q_f32(out[i].data, p);
+      }
+#endif
+
+      for (; i < count; ++i) {
+        out[i] = Fast ? fast_normalize(in[i]) : normalize(in[i]);
+      }
+    }
+
+    template<bool Fast>
+    void normalize_3d(const vec3f *in, vec3f *out, std::size_t count) {
+      std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+      for (; i + 4 <= count; i += 4) {
+        __m128 c[3];
+        load_points3(in[i].data, c[0], c[1], c[2]);
+        normalize4<Fast>(c);
+        store_points3(out[i].data, c[0], c[1], c[2]);
+      }
+#elif defined(HMI_SIMD_NEON)
+      for (; i + 4 <= count; i += 4) {
+        float32x4x3_t p = vld3q_f32(in[i].data);
+        normalize4<Fast>(p.val);
+        vst3q_f32(out[i].data, p);
+      }
+#endif
+
+      for (; i < count; ++i) {
+        out[i] = Fast ? fast_normalize(in[i]) : normalize(in[i]);
+      }
+    }
+
+#if defined(HMI_SIMD_SSE2)
+    #undef HMI_SHUFFLE
+#endif
+
+  }
+
+  void transform_points(const mat3f& m, span<const vec2f> in, span<vec2f> out) {
+    assert(in.size() == out.size());
+
+    auto kernel = [&m](const vec2f *in, vec2f *out, std::size_t count) {
+      transform_points_2d(m, in, out, count);
+    };
+
+    run_in_parallel(kernel, in.data(), out.data(), in.size());
+  }
+
+  void transform_points(const mat4f& m, span<const vec3f> in, span<vec3f> out) {
+    assert(in.size() == out.size());
+
+    auto kernel = [&m](const vec3f *in, vec3f *out, std::size_t count) {
+      transform_points_3d(m, in, out, count);
+    };
+
+    run_in_parallel(kernel, in.data(), out.data(), in.size());
+  }
+
+  void normalize(span<const vec2f> in, span<vec2f> out) {
+    assert(in.size() == out.size());
+    normalize_2d<false>(in.data(), out.data(), in.size());
+  }
+
+  void normalize(span<const vec3f> in, span<vec3f> out) {
+    assert(in.size() == out.size());
+    normalize_3d<false>(in.data(), out.data(), in.size());
+  }
+
+  void fast_normalize(span<const vec2f> in, span<vec2f> out) {
+    assert(in.size() == out.size());
+    normalize_2d<true>(in.data(), out.data(), in.size());
+  }
+
+  void fast_normalize(span<const vec3f> in, span<vec3f> out) {
+    assert(in.size() == out.size());
+    normalize_3d<true>(in.data(), out.data(), in.size());
+  }
+
+  namespace {
+
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+    // the polynomials of fast_sincos, evaluated in the same order
+    void sincos_poly4(detail::float4 r, detail::float4& s, detail::float4& c) {
+      using namespace detail;
+
+      float4 r2 = mul4(r, r);
+
+      float4 ps = add4(splat4(TRIG_SIN_2), mul4(r2, splat4(TRIG_SIN_3)));
+      ps = add4(splat4(TRIG_SIN_1), mul4(r2, ps));
+      s = add4(r, mul4(mul4(r, r2), ps));
+
+      float4 pc = add4(splat4(TRIG_COS_2), mul4(r2, splat4(TRIG_COS_3)));
+      pc = add4(splat4(TRIG_COS_1), mul4(r2, pc));
+      c = add4(sub4(splat4(1.0f), mul4(splat4(0.5f), r2)), mul4(mul4(r2, r2), pc));
+    }
+#endif
+
+  }
+
+  void fast_sincos(span<const float> angles, span<float> sines, span<float> cosines) {
+    assert(angles.size() == sines.size() && angles.size() == cosines.size());
+
+    using namespace detail;
+
+    const std::size_t count = angles.size();
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+
+    for (; i + 4 <= count; i += 4) {
+      __m128 x = _mm_loadu_ps(angles.data() + i);
+      __m128 scaled = _mm_mul_ps(x, _mm_set1_ps(TRIG_2_OVER_PI));
+      __m128 half = _mm_or_ps(_mm_and_ps(scaled, sign), _mm_set1_ps(0.5f));
+      __m128i k = _mm_cvttps_epi32(_mm_add_ps(scaled, half));
+      __m128 kf = _mm_cvtepi32_ps(k);
+
+      __m128 r = _mm_sub_ps(x, _mm_mul_ps(kf, _mm_set1_ps(TRIG_PI_2_A)));
+      r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(TRIG_PI_2_B)));
+      r = _mm_sub_ps(r, _mm_mul_ps(kf, _mm_set1_ps(TRIG_PI_2_C)));
+
+      __m128 s, c;
+      sincos_poly4(r, s, c);
+
+      // odd quadrants swap sine and cosine, then the signs come from bit 1 of k and k + 1
+      __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(k, one), one));
+      __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(k, two), 30));
+      __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(k, one), two), 30));
+
+      __m128 sin = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+      __m128 cos = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+      _mm_storeu_ps(sines.data() + i, _mm_xor_ps(sin, sin_sign));
+      _mm_storeu_ps(cosines.data() + i, _mm_xor_ps(cos, cos_sign));
+    }
+#elif defined(HMI_SIMD_NEON)
+    const uint32x4_t one = vdupq_n_u32(1);
+    const uint32x4_t two = vdupq_n_u32(2);
+    const uint32x4_t sign = vdupq_n_u32(0x80000000);
+
+    for (; i + 4 <= count; i += 4) {
+      float32x4_t x = vld1q_f32(angles.data() + i);
+      float32x4_t scaled = vmulq_n_f32(x, TRIG_2_OVER_PI);
+      uint32x4_t half = vorrq_u32(vandq_u32(vreinterpretq_u32_f32(scaled), sign), vreinterpretq_u32_f32(vdupq_n_f32(0.5f)));
+      int32x4_t k = vcvtq_s32_f32(vaddq_f32(scaled, vreinterpretq_f32_u32(half)));
+      float32x4_t kf = vcvtq_f32_s32(k);
+
+      float32x4_t r = vsubq_f32(x, vmulq_n_f32(kf, TRIG_PI_2_A));
+      r = vsubq_f32(r, vmulq_n_f32(kf, TRIG_PI_2_B));
+      r = vsubq_f32(r, vmulq_n_f32(kf, TRIG_PI_2_C));
+
+      float32x4_t s, c;
+      sincos_poly4(r, s, c);
+
+      uint32x4_t ku = vreinterpretq_u32_s32(k);
+      uint32x4_t swap = vceqq_u32(vandq_u32(ku, one), one);
+      uint32x4_t sin_sign = vshlq_n_u32(vandq_u32(ku, two), 30);
+      uint32x4_t cos_sign = vshlq_n_u32(vandq_u32(vaddq_u32(ku, one), two), 30);
+
+      uint32x4_t sin = vreinterpretq_u32_f32(vbslq_f32(swap, c, s));
+      uint32x4_t cos = vreinterpretq_u32_f32(vbslq_f32(swap, s, c));
+
+      vst1q_f32(sines.data() + i, vreinterpretq_f32_u32(veorq_u32(sin, sin_sign)));
+      vst1q_f32(cosines.data() + i, vreinterpretq_f32_u32(veorq_u32(cos, cos_sign)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+      hmi::fast_sincos(angles[i], sines[i], cosines[i]);
+    }
+  }
+
+  void evaluate(span<const cubic_bezier2f> curves, span<const float> t, span<vec2f> points) {
+    assert(curves.size() == t.size() && curves.size() == points.size());
+
+    const std::size_t count = curves.size();
+    std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+    using namespace detail;
+
+    const float4 one = splat4(1.0f);
+    const float4 three = splat4(3.0f);
+
+    for (; i + 4 <= count; i += 4) {
+      // after the transpositions, each float4 holds one coordinate of 4 curves
+      const float *p = curves[i].p0.data;
+
+      float4 x0 = load4(p), y0 = load4(p + 8), x1 = load4(p + 16), y1 = load4(p + 24);
+      float4 x2 = load4(p + 4), y2 = load4(p + 12), x3 = load4(p + 20), y3 = load4(p + 28);
+      transpose4(x0, y0, x1, y1);
+      transpose4(x2, y2, x3, y3);
+
+      float4 tt = load4(t.data() + i);
+      float4 u = sub4(one, tt);
+      float4 uu = mul4(u, u);
+      float4 t2 = mul4(tt, tt);
+
+      float4 b0 = mul4(uu, u);
+      float4 b1 = mul4(mul4(three, uu), tt);
+      float4 b2 = mul4(mul4(three, u), t2);
+      float4 b3 = mul4(t2, tt);
+
+      float4 x = madd4(x3, b3, madd4(x2, b2, madd4(x1, b1, mul4(x0, b0))));
+      float4 y = madd4(y3, b3, madd4(y2, b2, madd4(y1, b1, mul4(y0, b0))));
+
+#if defined(HMI_SIMD_SSE2)
+      _mm_storeu_ps(points[i].data, _mm_unpacklo_ps(x, y));
+      _mm_storeu_ps(points[i + 2].data, _mm_unpackhi_ps(x, y));
+#else
+      vst2q_f32(points[i].data, float32x4x2_t{ { x, y } });
+#endif
+    }
+#endif
+
+    for (; i < count; ++i) {
+      points[i] = hmi::evaluate(curves[i], t[i]);
+    }
+  }
+
+  namespace {
+
+    // the boxes are tested 4 at a time: after a transposition, each float4
+    // holds one bound of 4 boxes and the tests give a 4-bit mask
+
+    template<typename Test4, typename Test>
+    void find_boxes(span<const box2f> boxes, [[maybe_unused]] Test4 test4, Test test, std::vector<std::size_t>& result) {
+      static_assert(sizeof(box2f) == 4 * sizeof(float), "box2f should be made of 4 packed floats");
+
+      std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+      for (; i + 4 <= boxes.size(); i += 4) {
+        const float *p = boxes[i].min.data;
+
+        detail::float4 min_x = detail::load4(p);
+        detail::float4 min_y = detail::load4(p + 4);
+        detail::float4 max_x = detail::load4(p + 8);
+        detail::float4 max_y = detail::load4(p + 12);
+        detail::transpose4(min_x, min_y, max_x, max_y);
+
+        int mask = detail::mask4(test4(min_x, min_y, max_x, max_y));
+
+        while (mask != 0) {
+          int lane = 0;
+
+          while ((mask & (1 << lane)) == 0) {
+            ++lane;
+          }
+
+          result.push_back(i + lane);
+          mask &= ~(1 << lane);
+        }
+      }
+#endif
+
+      for (; i < boxes.size(); ++i) {
+        if (test(boxes[i])) {
+          result.push_back(i);
+        }
+      }
+    }
+
+  }
+
+  void find_containing(span<const box2f> boxes, vec2f point, std::vector<std::size_t>& result) {
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+    using namespace detail;
+
+    const float4 x = splat4(point[0]);
+    const float4 y = splat4(point[1]);
+
+    auto test4 = [x, y](float4 min_x, float4 min_y, float4 max_x, float4 max_y) {
+      return and4(and4(cmple4(min_x, x), cmple4(min_y, y)), and4(cmple4(x, max_x), cmple4(y, max_y)));
+    };
+#else
+    auto test4 = nullptr;
+#endif
+
+    find_boxes(boxes, test4, [point](const box2f& b) { return contains(b, point); }, result);
+  }
+
+  void find_intersecting(span<const box2f> boxes, const box2f& query, std::vector<std::size_t>& result) {
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+    using namespace detail;
+
+    const float4 query_min_x = splat4(query.min[0]);
+    const float4 query_min_y = splat4(query.min[1]);
+    const float4 query_max_x = splat4(query.max[0]);
+    const float4 query_max_y = splat4(query.max[1]);
+
+    auto test4 = [=](float4 min_x, float4 min_y, float4 max_x, float4 max_y) {
+      return and4(and4(cmple4(min_x, query_max_x), cmple4(min_y, query_max_y)), and4(cmple4(query_min_x, max_x), cmple4(query_min_y, max_y)));
+    };
+#else
+    auto test4 = nullptr;
+#endif
+
+    find_boxes(boxes, test4, [&query](const box2f& b) { return intersects(b, query); }, result);
+  }
+
+  namespace detail {
+
+    namespace {
+
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+      float4 apply4(soa_op op, float4 lhs, float4 rhs) {
+        switch (op) {
+          case soa_op::add:
+            return add4(lhs, rhs);
+          case soa_op::sub:
+            return sub4(lhs, rhs);
+          case soa_op::mul:
+            return mul4(lhs, rhs);
+          case soa_op::div:
+            return div4(lhs, rhs);
+        }
+
+        return lhs;
+      }
+#endif
+
+      // the operation is a template parameter so that the switch is out of the loop
+      template<soa_op Op, typename Rhs>
+      void apply_kernel(float *out, const float *lhs, Rhs rhs, std::size_t count) {
+        std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2) || defined(HMI_SIMD_NEON)
+        for (; i + 4 <= count; i += 4) {
+          if constexpr (std::is_pointer_v<Rhs>) {
+            store4(out + i, apply4(Op, load4(lhs + i), load4(rhs + i)));
+          } else {
+            store4(out + i, apply4(Op, load4(lhs + i), splat4(rhs)));
+          }
+        }
+#endif
+
+        for (; i < count; ++i) {
+          if constexpr (std::is_pointer_v<Rhs>) {
+            out[i] = soa_apply_one(Op, lhs[i], rhs[i]);
+          } else {
+            out[i] = soa_apply_one(Op, lhs[i], rhs);
+          }
+        }
+      }
+
+      template<typename Rhs>
+      void apply_any(soa_op op, float *out, const float *lhs, Rhs rhs, std::size_t count) {
+        switch (op) {
+          case soa_op::add:
+            apply_kernel<soa_op::add>(out, lhs, rhs, count);
+            break;
+          case soa_op::sub:
+            apply_kernel<soa_op::sub>(out, lhs, rhs, count);
+            break;
+          case soa_op::mul:
+            apply_kernel<soa_op::mul>(out, lhs, rhs, count);
+            break;
+          case soa_op::div:
+            apply_kernel<soa_op::div>(out, lhs, rhs, count);
+            break;
+        }
+      }
+
+    }
+
+    void soa_apply(soa_op op, float *out, const float *lhs, const float *rhs, std::size_t count) {
+      apply_any(op, out, lhs, rhs, count);
+    }
+
+    void soa_apply(soa_op op, float *out, const float *lhs, float rhs, std::size_t count) {
+      apply_any(op, out, lhs, rhs, count);
+    }
+
+    void soa_interleave(const float *x, const float *y, vec2f *out, std::size_t count) {
+      std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+      for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(out[i].data, _mm_unpacklo_ps(vx, vy));
+        _mm_storeu_ps(out[i + 2].data, _mm_unpackhi_ps(vx, vy));
+      }
+#elif defined(HMI_SIMD_NEON)
+      for (; i + 4 <= count; i += 4) {
+        float32x4x2_t p;
+        p.val[0] = vld1q_f32(x + i);
+        p.val[1] = vld1q_f32(y + i);
+        vst2q_f32(out[i].data, p);
+      }
+#endif
+
+      for (; i < count; ++i) {
+        out[i] = vec2f(x[i], y[i]);
+      }
+    }
+
+    void soa_deinterleave(const vec2f *in, float *x, float *y, std::size_t count) {
+      std::size_t i = 0;
+
+#if defined(HMI_SIMD_SSE2)
+      for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_loadu_ps(in[i].data);
+        __m128 b = _mm_loadu_ps(in[i + 2].data);
+        _mm_storeu_ps(x + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(y + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+      }
+#elif defined(HMI_SIMD_NEON)
+      for (; i + 4 <= count; i += 4) {
+        float32x4x2_t p = vld2q_f32(in[i].data);
+        vst1q_f32(x + i, p.val[0]);
+        vst1q_f32(y + i, p.val[1]);
+      }
+#endif
+
+      for (; i < count; ++i) {
+        x[i] = in[i][0];
+        y[i] = in[i][1];
+      }
+    }
+
+  }
+
+}
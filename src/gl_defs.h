@@ -0,0 +1,16 @@
+#ifndef HMI_SRC_GL_DEFS_H
+#define HMI_SRC_GL_DEFS_H
+
+#include <glad/glad.h>
+
+// GLES2 core formats missing from the generated loader
+
+#ifndef GL_LUMINANCE
+#define GL_LUMINANCE 0x1909
+#endif
+
+#ifndef GL_LUMINANCE_ALPHA
+#define GL_LUMINANCE_ALPHA 0x190A
+#endif
+
+#endif // HMI_SRC_GL_DEFS_H
@@ -0,0 +1,120 @@
+#include <bits/heatmap.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include "gl_defs.h"
+
+namespace hmi {
+
+  namespace {
+
+    constexpr std::size_t PALETTE_SIZE = 256;
+
+    std::uint8_t to_byte(float component) {
+      return static_cast<std::uint8_t>(std::clamp(component, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+  }
+
+  heatmap::heatmap(vec2i size, span<const color4f> palette)
+  : m_size(size)
+  , m_min(0.0f)
+  , m_max(1.0f)
+  , m_values_texture(0)
+  , m_palette_texture(0)
+  , m_buffer(2 * size.width * size.height, 0)
+  {
+    assert(size.width > 0 && size.height > 0);
+
+    // values, the filtering must be nearest because the two bytes of a value can not be interpolated
+
+    glGenTextures(1, &m_values_texture);
+    glBindTexture(GL_TEXTURE_2D, m_values_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    upload();
+
+    // palette
+
+    glGenTextures(1, &m_palette_texture);
+    glBindTexture(GL_TEXTURE_2D, m_palette_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    set_palette(palette);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  heatmap::~heatmap() {
+    if (m_values_texture != 0) {
+      glDeleteTextures(1, &m_values_texture);
+    }
+
+    if (m_palette_texture != 0) {
+      glDeleteTextures(1, &m_palette_texture);
+    }
+  }
+
+  void heatmap::set_palette(span<const color4f> palette) {
+    assert(!palette.empty());
+
+    // the colors of the palette are evenly spaced on [0, 1]
+
+    std::uint8_t lut[PALETTE_SIZE * 4];
+
+    for (std::size_t i = 0; i < PALETTE_SIZE; ++i) {
+      float position = static_cast<float>(i) / (PALETTE_SIZE - 1) * (palette.size() - 1);
+      std::size_t index = std::min(static_cast<std::size_t>(position), palette.size() - 1);
+      std::size_t next = std::min(index + 1, palette.size() - 1);
+      float t = position - index;
+
+      for (std::size_t j = 0; j < 4; ++j) {
+        lut[4 * i + j] = to_byte(palette[index][j] + t * (palette[next][j] - palette[index][j]));
+      }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_palette_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PALETTE_SIZE, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, lut);
+  }
+
+  void heatmap::update(span<const float> values) {
+    assert(values.size() == static_cast<std::size_t>(m_size.width) * static_cast<std::size_t>(m_size.height));
+
+    const float scale = (m_max > m_min) ? 65535.0f / (m_max - m_min) : 0.0f;
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      float normalized = std::clamp((values[i] - m_min) * scale, 0.0f, 65535.0f);
+      auto value = static_cast<std::uint16_t>(normalized + 0.5f);
+      m_buffer[2 * i] = static_cast<std::uint8_t>(value >> 8);
+      m_buffer[2 * i + 1] = static_cast<std::uint8_t>(value & 0xFF);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_values_texture);
+    upload();
+  }
+
+  void heatmap::update(span<const std::uint16_t> values) {
+    assert(values.size() == static_cast<std::size_t>(m_size.width) * static_cast<std::size_t>(m_size.height));
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      m_buffer[2 * i] = static_cast<std::uint8_t>(values[i] >> 8);
+      m_buffer[2 * i + 1] = static_cast<std::uint8_t>(values[i] & 0xFF);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_values_texture);
+    upload();
+  }
+
+  void heatmap::upload() {
+    // one texel holds a whole value: the high byte in luminance and the low byte in alpha
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE_ALPHA, m_size.width, m_size.height, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, m_buffer.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  }
+
+}
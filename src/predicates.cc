@@ -0,0 +1,326 @@
+#include <bits/predicates.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace hmi {
+
+  namespace {
+
+    // floating-point expansions (Shewchuk): a number is the exact sum of
+    // non-overlapping doubles, sorted by increasing magnitude, without zeros
+
+    using expansion = std::vector<double>;
+
+    void two_sum(double a, double b, double& x, double& y) {
+      x = a + b;
+      double b_virtual = x - a;
+      double a_virtual = x - b_virtual;
+      y = (a - a_virtual) + (b - b_virtual);
+    }
+
+    void fast_two_sum(double a, double b, double& x, double& y) {
+      x = a + b;
+      y = b - (x - a);
+    }
+
+    void two_product(double a, double b, double& x, double& y) {
+      x = a * b;
+      y = std::fma(a, b, -x);
+    }
+
+    expansion difference(double a, double b) {
+      double x, y;
+      two_sum(a, -b, x, y);
+
+      expansion result;
+
+      if (y != 0.0) {
+        result.push_back(y);
+      }
+
+      if (x != 0.0) {
+        result.push_back(x);
+      }
+
+      return result;
+    }
+
+    expansion grow(const expansion& e, double b) {
+      expansion result;
+      double q = b;
+
+      for (double component : e) {
+        double sum, error;
+        two_sum(q, component, sum, error);
+        q = sum;
+
+        if (error != 0.0) {
+          result.push_back(error);
+        }
+      }
+
+      if (q != 0.0) {
+        result.push_back(q);
+      }
+
+      return result;
+    }
+
+    expansion sum(const expansion& e, const expansion& f) {
+      expansion result = e;
+
+      for (double component : f) {
+        result = grow(result, component);
+      }
+
+      return result;
+    }
+
+    expansion negate(expansion e) {
+      for (double& component : e) {
+        component = -component;
+      }
+
+      return e;
+    }
+
+    expansion scale(const expansion& e, double b) {
+      expansion result;
+
+      if (e.empty() || b == 0.0) {
+        return result;
+      }
+
+      double q, error;
+      two_product(e[0], b, q, error);
+
+      if (error != 0.0) {
+        result.push_back(error);
+      }
+
+      for (std::size_t i = 1; i < e.size(); ++i) {
+        double high, low, partial;
+        two_product(e[i], b, high, low);
+        two_sum(q, low, partial, error);
+
+        if (error != 0.0) {
+          result.push_back(error);
+        }
+
+        fast_two_sum(high, partial, q, error);
+
+        if (error != 0.0) {
+          result.push_back(error);
+        }
+      }
+
+      if (q != 0.0) {
+        result.push_back(q);
+      }
+
+      return result;
+    }
+
+    expansion product(const expansion& e, const expansion& f) {
+      expansion result;
+
+      for (double component : f) {
+        result = sum(result, scale(e, component));
+      }
+
+      return result;
+    }
+
+    // the largest component has the sign of the expansion
+    double approximate(const expansion& e) {
+      return e.empty() ? 0.0 : e.back();
+    }
+
+  }
+
+  namespace detail {
+
+    double orient2d_exact(vec2d a, vec2d b, vec2d c) {
+      expansion acx = difference(a[0], c[0]);
+      expansion acy = difference(a[1], c[1]);
+      expansion bcx = difference(b[0], c[0]);
+      expansion bcy = difference(b[1], c[1]);
+
+      return approximate(sum(product(acx, bcy), negate(product(acy, bcx))));
+    }
+
+    double incircle_exact(vec2d a, vec2d b, vec2d c, vec2d d) {
+      expansion adx = difference(a[0], d[0]);
+      expansion ady = difference(a[1], d[1]);
+      expansion bdx = difference(b[0], d[0]);
+      expansion bdy = difference(b[1], d[1]);
+      expansion cdx = difference(c[0], d[0]);
+      expansion cdy = difference(c[1], d[1]);
+
+      expansion alift = sum(product(adx, adx), product(ady, ady));
+      expansion blift = sum(product(bdx, bdx), product(bdy, bdy));
+      expansion clift = sum(product(cdx, cdx), product(cdy, cdy));
+
+      expansion bc = sum(product(bdx, cdy), negate(product(cdx, bdy)));
+      expansion ca = sum(product(cdx, ady), negate(product(adx, cdy)));
+      expansion ab = sum(product(adx, bdy), negate(product(bdx, ady)));
+
+      return approximate(sum(sum(product(alift, bc), product(blift, ca)), product(clift, ab)));
+    }
+
+  }
+
+  namespace {
+
+    // one step of the winding number: +1 if the edge goes up on the left of
+    // the point, -1 if it goes down on the right, and the boundary is
+    // detected on the way
+
+    int winding_step(vec2f a, vec2f b, vec2f point, bool& boundary) {
+      if (point[1] < std::min(a[1], b[1]) || std::max(a[1], b[1]) < point[1]) {
+        return 0;
+      }
+
+      double side = orient2d(a, b, point);
+
+      if (side == 0.0) {
+        if (std::min(a[0], b[0]) <= point[0] && point[0] <= std::max(a[0], b[0])) {
+          boundary = true;
+        }
+
+        return 0;
+      }
+
+      if (a[1] <= point[1] && point[1] < b[1] && side > 0.0) {
+        return 1;
+      }
+
+      if (b[1] <= point[1] && point[1] < a[1] && side < 0.0) {
+        return -1;
+      }
+
+      return 0;
+    }
+
+    constexpr std::size_t MAX_BAND_COUNT = 256;
+
+  }
+
+  bool point_in_polygon(span<const vec2f> polygon, vec2f point) {
+    const std::size_t count = polygon.size();
+    int winding = 0;
+    bool boundary = false;
+
+    for (std::size_t i = 0; i < count; ++i) {
+      winding += winding_step(polygon[i], polygon[(i + 1) % count], point, boundary);
+
+      if (boundary) {
+        return true;
+      }
+    }
+
+    return winding != 0;
+  }
+
+  prepared_polygon::prepared_polygon(span<const vec2f> polygon)
+  : m_bounds(vec2f(0.0f, 0.0f), vec2f(0.0f, 0.0f))
+  , m_band_scale(0.0f)
+  {
+    const std::size_t count = polygon.size();
+
+    if (count == 0) {
+      m_band_offsets.assign(2, 0);
+      return;
+    }
+
+    m_bounds = box2f(polygon[0], polygon[0]);
+
+    for (vec2f vertex : polygon) {
+      m_bounds = merge(m_bounds, vertex);
+    }
+
+    const std::size_t band_count = std::min(count, MAX_BAND_COUNT);
+    const float height = m_bounds.max[1] - m_bounds.min[1];
+
+    if (height > 0.0f) {
+      m_band_scale = static_cast<float>(band_count) / height;
+    }
+
+    // the band of a coordinate is monotonic, so an edge and a point with the
+    // same y always meet in a band
+    auto band = [&](float y) {
+      std::size_t index = static_cast<std::size_t>((y - m_bounds.min[1]) * m_band_scale);
+      return std::min(index, band_count - 1);
+    };
+
+    m_band_offsets.assign(band_count + 1, 0);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      vec2f a = polygon[i];
+      vec2f b = polygon[(i + 1) % count];
+
+      for (std::size_t j = band(std::min(a[1], b[1])); j <= band(std::max(a[1], b[1])); ++j) {
+        ++m_band_offsets[j + 1];
+      }
+    }
+
+    for (std::size_t j = 0; j < band_count; ++j) {
+      m_band_offsets[j + 1] += m_band_offsets[j];
+    }
+
+    m_band_edges.resize(m_band_offsets[band_count]);
+    std::vector<std::uint32_t> next(m_band_offsets.begin(), m_band_offsets.end() - 1);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      vec2f a = polygon[i];
+      vec2f b = polygon[(i + 1) % count];
+
+      for (std::size_t j = band(std::min(a[1], b[1])); j <= band(std::max(a[1], b[1])); ++j) {
+        m_band_edges[next[j]++] = { a, b };
+      }
+    }
+  }
+
+  bool prepared_polygon::contains(vec2f point) const {
+    if (m_band_edges.empty() || !hmi::contains(m_bounds, point)) {
+      return false;
+    }
+
+    const std::size_t band_count = m_band_offsets.size() - 1;
+    std::size_t band = std::min(static_cast<std::size_t>((point[1] - m_bounds.min[1]) * m_band_scale), band_count - 1);
+
+    int winding = 0;
+    bool boundary = false;
+
+    for (std::uint32_t i = m_band_offsets[band]; i < m_band_offsets[band + 1]; ++i) {
+      winding += winding_step(m_band_edges[i].a, m_band_edges[i].b, point, boundary);
+
+      if (boundary) {
+        return true;
+      }
+    }
+
+    return winding != 0;
+  }
+
+  void find_inside(span<const vec2f> polygon, span<const vec2f> points, std::vector<std::size_t>& result) {
+    prepared_polygon prepared(polygon);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      if (prepared.contains(points[i])) {
+        result.push_back(i);
+      }
+    }
+  }
+
+  void find_containing(span<const prepared_polygon> polygons, vec2f point, std::vector<std::size_t>& result) {
+    for (std::size_t i = 0; i < polygons.size(); ++i) {
+      if (polygons[i].contains(point)) {
+        result.push_back(i);
+      }
+    }
+  }
+
+}
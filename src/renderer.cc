@@ -1,14 +1,26 @@
 #include <bits/renderer.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 
 #include <SDL.h>
 #include <glad/glad.h>
 
+#include <bits/box.h>
 #include <bits/color.h>
+#include <bits/fixed.h>
+#include <bits/heatmap.h>
 #include <bits/mat_ops.h>
+#include <bits/simd.h>
+#include <bits/tilemap.h>
+#include <bits/trace_buffer.h>
+#include <bits/transform.h>
+#include <bits/trig.h>
+#include <bits/video_surface.h>
 #include <bits/vec_ops.h>
 
 namespace hmi {
@@ -47,6 +59,115 @@ namespace hmi {
       }
     )shader";
 
+    constexpr const char *g_textured_vertex_shader = R"shader(
+      #version 100
+
+      attribute vec2 a_position;
+      attribute vec2 a_tex_coords;
+
+      varying vec2 v_tex_coords;
+
+      uniform mat3 u_transform;
+
+      void main(void) {
+        v_tex_coords = a_tex_coords;
+
+        vec3 worldPosition = vec3(a_position, 1);
+        vec3 normalizedPosition = worldPosition * u_transform;
+
+        gl_Position = vec4(normalizedPosition.xy, 0, 1);
+      }
+    )shader";
+
+    // the values are 16-bit unsigned integers stored in luminance (high byte) and alpha (low byte)
+    // the palette is a 256x1 texture with linear filtering
+
+    constexpr const char *g_heatmap_fragment_shader = R"shader(
+      #version 100
+
+      #ifdef GL_FRAGMENT_PRECISION_HIGH
+      precision highp float;
+      #else
+      precision mediump float;
+      #endif
+
+      varying vec2 v_tex_coords;
+
+      uniform sampler2D u_texture0; // values
+      uniform sampler2D u_texture1; // palette
+
+      void main(void) {
+        vec4 texel = texture2D(u_texture0, v_tex_coords);
+        float value = (texel.r * 65280.0 + texel.a * 255.0) / 65535.0;
+        gl_FragColor = texture2D(u_texture1, vec2(value * (255.0 / 256.0) + (0.5 / 256.0), 0.5));
+      }
+    )shader";
+
+    // the indices of the tiles are stored in alpha
+    // the palette is a 256x1 texture with nearest filtering
+
+    constexpr const char *g_tilemap_fragment_shader = R"shader(
+      #version 100
+
+      precision mediump float;
+
+      varying vec2 v_tex_coords;
+
+      uniform sampler2D u_texture0; // indices
+      uniform sampler2D u_texture1; // palette
+
+      void main(void) {
+        float index = texture2D(u_texture0, v_tex_coords).a * 255.0;
+        gl_FragColor = texture2D(u_texture1, vec2((index + 0.5) / 256.0, 0.5));
+      }
+    )shader";
+
+    // YUV to RGB conversion with BT.601 coefficients (limited range)
+    // U is read in luminance and V in alpha, so that an interleaved UV plane can be bound twice
+
+    constexpr const char *g_video_fragment_shader = R"shader(
+      #version 100
+
+      precision mediump float;
+
+      varying vec2 v_tex_coords;
+
+      uniform sampler2D u_texture0; // Y
+      uniform sampler2D u_texture1; // U
+      uniform sampler2D u_texture2; // V
+
+      void main(void) {
+        float y = 1.1644 * (texture2D(u_texture0, v_tex_coords).r - 0.0625);
+        float u = texture2D(u_texture1, v_tex_coords).r - 0.5;
+        float v = texture2D(u_texture2, v_tex_coords).a - 0.5;
+        gl_FragColor = vec4(y + 1.5960 * v, y - 0.3918 * u - 0.8130 * v, y + 2.0172 * u, 1.0);
+      }
+    )shader";
+
+    // the points of the circles are computed once, at compile time, and
+    // scaled by the radius; the last point closes the triangle fan
+
+    constexpr int CIRCLE_POINT_COUNT = 50;
+
+    struct unit_circle {
+      vec2f points[CIRCLE_POINT_COUNT + 1];
+    };
+
+    constexpr unit_circle make_unit_circle() {
+      constexpr float PI = 3.14159265359f;
+      unit_circle result{};
+
+      for (int i = 0; i < CIRCLE_POINT_COUNT + 1; ++i) {
+        float sin = 0.0f, cos = 0.0f;
+        fast_sincos(2 * PI * i / CIRCLE_POINT_COUNT, sin, cos);
+        result.points[i] = vec2f(sin, cos);
+      }
+
+      return result;
+    }
+
+    constexpr unit_circle g_unit_circle = make_unit_circle();
+
     GLuint compile_shader(const char *code, GLenum type) {
       GLuint id = glCreateShader(type);
 
@@ -78,9 +199,214 @@ namespace hmi {
       return id;
     }
 
-    constexpr
-    vec2f affine_transform(const mat3f& mat, vec2f point) {
-      return { mat.xx * point.x + mat.xy * point.y + mat.xz, mat.yx * point.x + mat.yy * point.y + mat.yz };
+    GLuint create_program(const char *vertex_shader, const char *fragment_shader) {
+      GLuint program = glCreateProgram();
+
+      GLuint vertex_shader_id = compile_shader(vertex_shader, GL_VERTEX_SHADER);
+      glAttachShader(program, vertex_shader_id);
+      glDeleteShader(vertex_shader_id); // the shader is still here because it is attached to the program
+
+      GLuint fragment_shader_id = compile_shader(fragment_shader, GL_FRAGMENT_SHADER);
+      glAttachShader(program, fragment_shader_id);
+      glDeleteShader(fragment_shader_id); // the shader is still here because it is attached to the program
+
+      glLinkProgram(program);
+
+      GLint link_status = GL_FALSE;
+      glGetProgramiv(program, GL_LINK_STATUS, &link_status);
+
+      if (link_status == GL_FALSE) {
+        GLint info_log_length;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &info_log_length);
+
+        assert(info_log_length > 0);
+        std::unique_ptr<char[]> info_log(new char[info_log_length]);
+        glGetProgramInfoLog(program, info_log_length, nullptr, info_log.get());
+
+        std::cerr << "Error while linking the program: " << info_log.get() << std::endl;
+      }
+
+      return program;
+    }
+
+    GLint get_attribute_location(GLuint program, const char *name) {
+      GLint loc = glGetAttribLocation(program, name);
+
+      if (loc == -1) {
+        std::cerr << "Attribute not found: " << name << std::endl;
+      }
+
+      return loc;
+    }
+
+    GLint get_uniform_location(GLuint program, const char *name) {
+      GLint loc = glGetUniformLocation(program, name);
+
+      if (loc == -1) {
+        std::cerr << "Uniform not found: " << name << std::endl;
+      }
+
+      return loc;
+    }
+
+    // minimum and maximum of the y coordinates of a non-empty range of points
+
+    void min_max_y(const vec2f *points, std::size_t count, float& min, float& max) {
+      assert(count > 0);
+
+      std::size_t i = 0;
+      min = max = points[0].data[1];
+
+#if defined(HMI_SIMD_SSE2)
+      if (count >= 4) {
+        __m128 vmin = _mm_set1_ps(min);
+        __m128 vmax = vmin;
+
+        for (; i + 4 <= count; i += 4) {
+          __m128 lo = _mm_loadu_ps(points[i].data);     // x0 y0 x1 y1
+          __m128 hi = _mm_loadu_ps(points[i + 2].data); // x2 y2 x3 y3
+          __m128 y = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+          vmin = _mm_min_ps(vmin, y);
+          vmax = _mm_max_ps(vmax, y);
+        }
+
+        vmin = _mm_min_ps(vmin, _mm_shuffle_ps(vmin, vmin, _MM_SHUFFLE(1, 0, 3, 2)));
+        vmin = _mm_min_ps(vmin, _mm_shuffle_ps(vmin, vmin, _MM_SHUFFLE(2, 3, 0, 1)));
+        vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(1, 0, 3, 2)));
+        vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(2, 3, 0, 1)));
+        min = _mm_cvtss_f32(vmin);
+        max = _mm_cvtss_f32(vmax);
+      }
+#elif defined(HMI_SIMD_NEON)
+      if (count >= 4) {
+        float32x4_t vmin = vdupq_n_f32(min);
+        float32x4_t vmax = vmin;
+
+        for (; i + 4 <= count; i += 4) {
+          float32x4x2_t xy = vld2q_f32(points[i].data); // deinterleave x and y
+          vmin = vminq_f32(vmin, xy.val[1]);
+          vmax = vmaxq_f32(vmax, xy.val[1]);
+        }
+
+        float32x2_t pmin = vpmin_f32(vget_low_f32(vmin), vget_high_f32(vmin));
+        float32x2_t pmax = vpmax_f32(vget_low_f32(vmax), vget_high_f32(vmax));
+        min = vget_lane_f32(vpmin_f32(pmin, pmin), 0);
+        max = vget_lane_f32(vpmax_f32(pmax, pmax), 0);
+      }
+#endif
+
+      for (; i < count; ++i) {
+        min = std::min(min, points[i].data[1]);
+        max = std::max(max, points[i].data[1]);
+      }
+    }
+
+    // a full check of the order would scan the whole strip at each frame,
+    // even when only a few points are visible: only the ends and a bounded
+    // sample of pairs are checked here, the visible points are checked after
+    // the culling
+
+    template<typename Point>
+    bool looks_sorted_by_x(const Point *points, std::size_t count) {
+      constexpr std::size_t SAMPLES = 64;
+
+      if (points[count - 1].data[0] < points[0].data[0]) {
+        return false;
+      }
+
+      std::size_t step = std::max<std::size_t>(count / SAMPLES, 1);
+
+      for (std::size_t i = 0; i + 1 < count; i += step) {
+        if (points[i + 1].data[0] < points[i].data[0] || (i + step < count && points[i + step].data[0] < points[i].data[0])) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    // keep at most two points (the minimum and the maximum) per column of pixels
+    // the points must be sorted by increasing x
+
+    void decimate_min_max(const vec2f *points, std::size_t count, float left, float column_width, std::vector<vec2f>& result) {
+      auto by_x = [](const vec2f& point, float x) { return point.data[0] < x; };
+
+      std::size_t i = 0;
+
+      while (i < count) {
+        float column = std::floor((points[i].data[0] - left) / column_width);
+        float limit = left + (column + 1) * column_width;
+
+        std::size_t j = std::lower_bound(points + i, points + count, limit, by_x) - points;
+
+        if (j == i) { // rounding problem on the column boundary
+          j = i + 1;
+        }
+
+        if (j - i <= 2) {
+          result.insert(result.end(), points + i, points + j);
+        } else {
+          float min, max;
+          min_max_y(points + i, j - i, min, max);
+
+          float first_x = points[i].data[0];
+          float last_x = points[j - 1].data[0];
+
+          // keep the overall direction of the trace inside the column
+          if (points[i].data[1] <= points[j - 1].data[1]) {
+            result.emplace_back(first_x, min);
+            result.emplace_back(last_x, max);
+          } else {
+            result.emplace_back(first_x, max);
+            result.emplace_back(last_x, min);
+          }
+        }
+
+        i = j;
+      }
+    }
+
+    // the same decimation on fixed-point values, with integer operations only:
+    // the column of a point is exact, there is no rounding problem
+
+    void decimate_min_max(const vec2x *points, std::size_t count, fixed16_16 left, std::int64_t column_width, std::vector<vec2x>& result) {
+      auto by_x = [](const vec2x& point, std::int64_t x) { return point.data[0].raw < x; };
+
+      std::size_t i = 0;
+
+      while (i < count) {
+        std::int64_t offset = std::int64_t(points[i].data[0].raw) - left.raw;
+        std::int64_t column = offset >= 0 ? offset / column_width : - ((- offset + column_width - 1) / column_width);
+        std::int64_t limit = left.raw + (column + 1) * column_width;
+
+        std::size_t j = std::lower_bound(points + i, points + count, limit, by_x) - points;
+
+        if (j - i <= 2) {
+          result.insert(result.end(), points + i, points + j);
+        } else {
+          fixed16_16 min = points[i].data[1];
+          fixed16_16 max = points[i].data[1];
+
+          for (std::size_t k = i + 1; k < j; ++k) {
+            min = std::min(min, points[k].data[1]);
+            max = std::max(max, points[k].data[1]);
+          }
+
+          fixed16_16 first_x = points[i].data[0];
+          fixed16_16 last_x = points[j - 1].data[0];
+
+          // keep the overall direction of the trace inside the column
+          if (points[i].data[1] <= points[j - 1].data[1]) {
+            result.emplace_back(first_x, min);
+            result.emplace_back(last_x, max);
+          } else {
+            result.emplace_back(first_x, max);
+            result.emplace_back(last_x, min);
+          }
+        }
+
+        i = j;
+      }
     }
 
   }
@@ -89,6 +415,10 @@ namespace hmi {
   : m_window(window)
   , m_context(nullptr)
   , m_program(0)
+  , m_heatmap_program(0)
+  , m_tilemap_program(0)
+  , m_video_program(0)
+  , m_srgb(false)
   {
     // create context
 
@@ -111,6 +441,24 @@ namespace hmi {
       std::cerr << "Failed to load GLES2" << std::endl;
     }
 
+    // the sRGB mode needs a framebuffer that really encodes sRGB (the
+    // attribute is only what the window asked for) and a way to write the
+    // sRGB texels as is; then the blending is done in linear space and the
+    // colors are converted once per draw call
+
+    int srgb_capable = 0;
+
+    if (SDL_GL_GetAttribute(SDL_GL_FRAMEBUFFER_SRGB_CAPABLE, &srgb_capable) == 0 && srgb_capable != 0 && GLAD_GL_EXT_sRGB && GLAD_GL_EXT_sRGB_write_control) {
+      GLint encoding = GL_LINEAR;
+      glGetError(); // a previous error would hide the one of the query
+      glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK, GL_FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING_EXT, &encoding);
+
+      if (glGetError() == GL_NO_ERROR && encoding == GL_SRGB_EXT) {
+        m_srgb = true;
+        glEnable(GL_FRAMEBUFFER_SRGB_EXT);
+      }
+    }
+
     glEnable(GL_BLEND);
     glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
@@ -120,33 +468,12 @@ namespace hmi {
     m_view_size = get_size();
     m_view_center = m_view_size / 2.0f;
 
-    // create shader
-
-    m_program = glCreateProgram();
-
-    GLuint vertex_shader_id = compile_shader(g_vertex_shader, GL_VERTEX_SHADER);
-    glAttachShader(m_program, vertex_shader_id);
-    glDeleteShader(vertex_shader_id); // the shader is still here because it is attached to the program
-
-    GLuint fragment_shader_id = compile_shader(g_fragment_shader, GL_FRAGMENT_SHADER);
-    glAttachShader(m_program, fragment_shader_id);
-    glDeleteShader(fragment_shader_id); // the shader is still here because it is attached to the program
-
-    glLinkProgram(m_program);
+    // create shaders
 
-    GLint link_status = GL_FALSE;
-    glGetProgramiv(m_program, GL_LINK_STATUS, &link_status);
-
-    if (link_status == GL_FALSE) {
-      GLint info_log_length;
-      glGetProgramiv(m_program, GL_INFO_LOG_LENGTH, &info_log_length);
-
-      assert(info_log_length > 0);
-      std::unique_ptr<char[]> info_log(new char[info_log_length]);
-      glGetProgramInfoLog(m_program, info_log_length, nullptr, info_log.get());
-
-      std::cerr << "Error while linking the program: " << info_log.get() << std::endl;
-    }
+    m_program = create_program(g_vertex_shader, g_fragment_shader);
+    m_heatmap_program = create_program(g_textured_vertex_shader, g_heatmap_fragment_shader);
+    m_tilemap_program = create_program(g_textured_vertex_shader, g_tilemap_fragment_shader);
+    m_video_program = create_program(g_textured_vertex_shader, g_video_fragment_shader);
 
     // initialize the screen
 
@@ -160,6 +487,18 @@ namespace hmi {
       glDeleteProgram(m_program);
     }
 
+    if (m_heatmap_program != 0) {
+      glDeleteProgram(m_heatmap_program);
+    }
+
+    if (m_tilemap_program != 0) {
+      glDeleteProgram(m_tilemap_program);
+    }
+
+    if (m_video_program != 0) {
+      glDeleteProgram(m_video_program);
+    }
+
     // delete context
 
     if (m_context != nullptr) {
@@ -181,17 +520,17 @@ namespace hmi {
     normalized.x = 2.0f * (position.x - viewport_position.x) / viewport_size.width - 1;
     normalized.y = 1 - 2.0f * (position.y - viewport_position.y) / viewport_size.height;
 
-    mat3f inverse_transform = invert(get_view_matrix());
-
-    return affine_transform(inverse_transform, normalized);
+    return transform_point(invert(get_view_transform()), normalized);
   }
 
   void renderer::clear(color4f color) {
+    color = get_output_color(color);
     glClearColor(color.r, color.g, color.b, color.a);
     glClear(GL_COLOR_BUFFER_BIT);
   }
 
   void renderer::fill_rectangle(vec2f coords, vec2f size, color4f color) {
+    color = get_output_color(color);
     vertex vertices[4];
 
     vertices[0].position = { coords.x,              coords.y                };
@@ -205,6 +544,7 @@ namespace hmi {
   }
 
   void renderer::draw_rectangle(vec2f coords, vec2f size, color4f color) {
+    color = get_output_color(color);
     vertex vertices[4];
 
     vertices[0].position = { coords.x,              coords.y                };
@@ -218,96 +558,365 @@ namespace hmi {
   }
 
   void renderer::fill_circle(vec2f center, float radius, color4f color) {
-    static constexpr int POINT_COUNT = 50;
-    static constexpr float PI = 3.14159265359f;
-
-    vertex vertices[POINT_COUNT + 2];
+    color = get_output_color(color);
+    vertex vertices[CIRCLE_POINT_COUNT + 2];
 
     vertices[0].position = center;
     vertices[0].color = color;
 
-    for (int i = 0; i < POINT_COUNT + 1; ++i) {
-      float angle = 2 * PI * i / POINT_COUNT;
-      vertices[i + 1].position = center + radius * vec2f(std::sin(angle), std::cos(angle));
+    for (int i = 0; i < CIRCLE_POINT_COUNT + 1; ++i) {
+      vertices[i + 1].position = center + radius * g_unit_circle.points[i];
       vertices[i + 1].color = color;
     }
 
-    draw(&vertices[0], POINT_COUNT + 2, GL_TRIANGLE_FAN);
+    draw(&vertices[0], CIRCLE_POINT_COUNT + 2, GL_TRIANGLE_FAN);
   }
 
   void renderer::draw_circle(vec2f center, float radius, color4f color) {
-    static constexpr int POINT_COUNT = 50;
-    static constexpr float PI = 3.14159265359f;
-
-    vertex vertices[POINT_COUNT];
+    color = get_output_color(color);
+    vertex vertices[CIRCLE_POINT_COUNT];
 
-    for (int i = 0; i < POINT_COUNT; ++i) {
-      float angle = 2 * PI * i / POINT_COUNT;
-      vertices[i].position = center + radius * vec2f(std::sin(angle), std::cos(angle));
+    for (int i = 0; i < CIRCLE_POINT_COUNT; ++i) {
+      vertices[i].position = center + radius * g_unit_circle.points[i];
       vertices[i].color = color;
     }
 
-    draw(&vertices[0], POINT_COUNT, GL_LINE_LOOP);
+    draw(&vertices[0], CIRCLE_POINT_COUNT, GL_LINE_LOOP);
   }
 
+  void renderer::draw_line_strip(span<const vec2f> points, color4f color, float width) {
+    if (points.size() < 2) {
+      return;
+    }
+
+    vec2i size = get_size();
+
+    if (size.width <= 0) {
+      return;
+    }
+
+    // the size of the view may be negative
+    float left = std::min(m_view_center.x - m_view_size.width / 2, m_view_center.x + m_view_size.width / 2);
+    float right = std::max(m_view_center.x - m_view_size.width / 2, m_view_center.x + m_view_size.width / 2);
+
+    auto by_x = [](const vec2f& point, float x) { return point.data[0] < x; };
+    auto by_x_reversed = [](float x, const vec2f& point) { return x < point.data[0]; };
+    auto compare_x = [](const vec2f& lhs, const vec2f& rhs) { return lhs.data[0] < rhs.data[0]; };
+
+    const vec2f *begin = points.begin();
+    const vec2f *end = points.end();
+
+    // the culling and the decimation need the points sorted by x, any other
+    // strip is drawn as is
+    bool sorted = looks_sorted_by_x(begin, points.size());
+
+    if (sorted) {
+      // only keep the visible points, and one more on each side
+      begin = std::lower_bound(points.begin(), points.end(), left, by_x);
+      end = std::upper_bound(begin, points.end(), right, by_x_reversed);
+
+      if (begin != points.begin()) {
+        --begin;
+      }
+
+      if (end != points.end()) {
+        ++end;
+      }
+
+      // the visible points are processed anyway, checking them costs no more
+      sorted = std::is_sorted(begin, end, compare_x);
+
+      if (!sorted) {
+        begin = points.begin();
+        end = points.end();
+      }
+    }
+
+    std::size_t count = end - begin;
+    std::size_t columns = size.width;
+
+    glLineWidth(width);
+
+    if (!sorted || count <= 2 * columns) {
+      // not enough points to need a decimation, draw directly from the buffer
+      draw(begin, count, color, GL_LINE_STRIP);
+    } else {
+      m_line_buffer.clear();
+      m_line_buffer.reserve(2 * columns + 4);
+      decimate_min_max(begin, count, left, (right - left) / columns, m_line_buffer);
+      draw(m_line_buffer.data(), m_line_buffer.size(), color, GL_LINE_STRIP);
+    }
+
+    glLineWidth(1.0f);
+  }
+
+  void renderer::draw_line_strip(span<const vec2x> points, color4f color, float width) {
+    if (points.size() < 2) {
+      return;
+    }
+
+    vec2i size = get_size();
+
+    if (size.width <= 0) {
+      return;
+    }
+
+    // the same culling as the float version, on the fixed-point values
+
+    float left_edge = std::min(m_view_center.x - m_view_size.width / 2, m_view_center.x + m_view_size.width / 2);
+    float right_edge = std::max(m_view_center.x - m_view_size.width / 2, m_view_center.x + m_view_size.width / 2);
+
+    fixed16_16 left(left_edge);
+    fixed16_16 right(right_edge);
+
+    auto by_x = [](const vec2x& point, fixed16_16 x) { return point.data[0] < x; };
+    auto by_x_reversed = [](fixed16_16 x, const vec2x& point) { return x < point.data[0]; };
+    auto compare_x = [](const vec2x& lhs, const vec2x& rhs) { return lhs.data[0] < rhs.data[0]; };
+
+    const vec2x *begin = points.begin();
+    const vec2x *end = points.end();
+    bool sorted = looks_sorted_by_x(begin, points.size());
+
+    if (sorted) {
+      begin = std::lower_bound(points.begin(), points.end(), left, by_x);
+      end = std::upper_bound(begin, points.end(), right, by_x_reversed);
+
+      if (begin != points.begin()) {
+        --begin;
+      }
+
+      if (end != points.end()) {
+        ++end;
+      }
+
+      sorted = std::is_sorted(begin, end, compare_x);
+
+      if (!sorted) {
+        begin = points.begin();
+        end = points.end();
+      }
+    }
+
+    std::size_t count = end - begin;
+    std::size_t columns = size.width;
+
+    glLineWidth(width);
+
+    if (!sorted || count <= 2 * columns) {
+      // the points are sent as GL_FIXED, without any conversion
+      draw(begin, count, color, GL_LINE_STRIP);
+    } else {
+      // the columns are rounded up so that there are at most as many as pixels
+      std::int64_t range = std::int64_t(right.raw) - left.raw;
+      std::int64_t column_count = columns;
+      std::int64_t column_width = std::max<std::int64_t>((range + column_count - 1) / column_count, 1);
+
+      m_fixed_line_buffer.clear();
+      m_fixed_line_buffer.reserve(2 * columns + 4);
+      decimate_min_max(begin, count, left, column_width, m_fixed_line_buffer);
+      draw(m_fixed_line_buffer.data(), m_fixed_line_buffer.size(), color, GL_LINE_STRIP);
+    }
+
+    glLineWidth(1.0f);
+  }
+
+  void renderer::draw_trace(const trace_buffer& trace, color4f color, float width) {
+    vec2i size = get_size();
+
+    if (size.width <= 0) {
+      return;
+    }
+
+    // the size of the view may be negative
+    float left = std::min(m_view_center.x - m_view_size.width / 2, m_view_center.x + m_view_size.width / 2);
+    float right = std::max(m_view_center.x - m_view_size.width / 2, m_view_center.x + m_view_size.width / 2);
+
+    m_line_buffer.clear();
+    trace.decimate(left, right, size.width, m_line_buffer);
+
+    if (m_line_buffer.size() < 2) {
+      return;
+    }
+
+    glLineWidth(width);
+    draw(m_line_buffer.data(), m_line_buffer.size(), color, GL_LINE_STRIP);
+    glLineWidth(1.0f);
+  }
+
+  void renderer::draw_heatmap(const heatmap& map, vec2f coords, vec2f size) {
+    const uint32_t textures[] = { map.m_values_texture, map.m_palette_texture };
+    draw_textured(m_heatmap_program, textures, coords, size, { 1.0f, 1.0f });
+  }
+
+  void renderer::draw_tilemap(tilemap& map, vec2f coords, vec2f tile_size) {
+    // find the visible chunks
+
+    box2f view = get_view_box();
+    vec2f chunk_size = tile_size * static_cast<float>(tilemap::chunk_size);
+    vec2f view_min = (view.min - coords) / chunk_size;
+    vec2f view_max = (view.max - coords) / chunk_size;
+
+    vec2i chunk_count = map.get_chunk_count();
+    vec2i chunk_min, chunk_max;
+
+    for (std::size_t i = 0; i < 2; ++i) {
+      chunk_min[i] = std::max(static_cast<int>(std::floor(view_min[i])), 0);
+      chunk_max[i] = std::min(static_cast<int>(std::ceil(view_max[i])), chunk_count[i]);
+    }
+
+    vec2i map_size = map.get_size();
+    vec2i chunk;
+
+    for (chunk.y = chunk_min.y; chunk.y < chunk_max.y; ++chunk.y) {
+      for (chunk.x = chunk_min.x; chunk.x < chunk_max.x; ++chunk.x) {
+        const uint32_t textures[] = { map.get_chunk_texture(chunk), map.m_palette_texture };
+
+        vec2i first_tile = chunk * tilemap::chunk_size;
+        vec2f tiles = { static_cast<float>(std::min(tilemap::chunk_size, map_size.width - first_tile.x)), static_cast<float>(std::min(tilemap::chunk_size, map_size.height - first_tile.y)) };
+
+        draw_textured(m_tilemap_program, textures, coords + first_tile * tile_size, tiles * tile_size, tiles / static_cast<float>(tilemap::chunk_size));
+      }
+    }
+  }
+
+  void renderer::draw_video(video_surface& surface, vec2f coords, vec2f size) {
+    const auto& planes = surface.get_planes();
+    const uint32_t textures[] = { planes.y, planes.u, planes.v };
+    draw_textured(m_video_program, textures, coords, size, { 1.0f, 1.0f });
+  }
+
+  void renderer::draw_textured(uint32_t program, span<const uint32_t> textures, vec2f coords, vec2f size, vec2f tex_size) {
+    static constexpr const char *texture_names[] = { "u_texture0", "u_texture1", "u_texture2" };
+    static constexpr std::size_t MAX_TEXTURES = sizeof texture_names / sizeof texture_names[0];
+
+    assert(textures.size() <= MAX_TEXTURES);
+
+    struct textured_vertex {
+      vec2f position;
+      vec2f tex_coords;
+    };
+
+    textured_vertex vertices[4];
+
+    vertices[0].position = { coords.x,              coords.y                };
+    vertices[1].position = { coords.x,              coords.y + size.height  };
+    vertices[2].position = { coords.x + size.width, coords.y                };
+    vertices[3].position = { coords.x + size.width, coords.y + size.height  };
+
+    vertices[0].tex_coords = { 0.0f,           0.0f            };
+    vertices[1].tex_coords = { 0.0f,           tex_size.height };
+    vertices[2].tex_coords = { tex_size.width, 0.0f            };
+    vertices[3].tex_coords = { tex_size.width, tex_size.height };
+
+    if (!prepare_draw(program)) {
+      return;
+    }
+
+    GLint position_loc = get_attribute_location(program, "a_position");
+    GLint tex_coords_loc = get_attribute_location(program, "a_tex_coords");
+
+    if (position_loc == -1 || tex_coords_loc == -1) {
+      return;
+    }
+
+    // bind textures
+
+    for (std::size_t i = 0; i < textures.size(); ++i) {
+      GLint texture_loc = get_uniform_location(program, texture_names[i]);
+
+      if (texture_loc == -1) {
+        return;
+      }
+
+      glActiveTexture(GL_TEXTURE0 + i);
+      glBindTexture(GL_TEXTURE_2D, textures[i]);
+      glUniform1i(texture_loc, i);
+    }
+
+    // send data
+
+    glEnableVertexAttribArray(position_loc);
+    glEnableVertexAttribArray(tex_coords_loc);
+
+    glVertexAttribPointer(position_loc, 2, GL_FLOAT, GL_FALSE, sizeof(textured_vertex), &vertices[0].position);
+    glVertexAttribPointer(tex_coords_loc, 2, GL_FLOAT, GL_FALSE, sizeof(textured_vertex), &vertices[0].tex_coords);
+
+    // the textures hold sRGB values that are written as is
+    if (m_srgb) {
+      glDisable(GL_FRAMEBUFFER_SRGB_EXT);
+    }
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    if (m_srgb) {
+      glEnable(GL_FRAMEBUFFER_SRGB_EXT);
+    }
+
+    glDisableVertexAttribArray(position_loc);
+    glDisableVertexAttribArray(tex_coords_loc);
+
+    // unbind textures
+
+    for (std::size_t i = textures.size(); i > 0; --i) {
+      glActiveTexture(GL_TEXTURE0 + i - 1);
+      glBindTexture(GL_TEXTURE_2D, 0);
+    }
+  }
 
   void renderer::display() {
     SDL_GL_SwapWindow(m_window);
   }
 
-  mat3f renderer::get_view_matrix() const {
-    mat3f scaling(
-      2.0f / m_view_size.x, 0.0f,                   0.0f,
-      0.0f,                 - 2.0f / m_view_size.y, 0.0f,
-      0.0f,                 0.0f,                   1.0f
-    );
+  box2f renderer::get_view_box() const {
+    // the size of the view may be negative
+    return box2f::from_position_size(m_view_center - m_view_size / 2.0f, m_view_size);
+  }
 
-    mat3f translation(
-      1.0f, 0.0f, - m_view_center.x,
-      0.0f, 1.0f, - m_view_center.y,
-      0.0f, 0.0f, 1.0f
-    );
+  transform2f renderer::get_view_transform() const {
+    vec2f scale(2.0f / m_view_size.x, - 2.0f / m_view_size.y);
+    return transform2f::scaling(scale) * transform2f::translation(- m_view_center);
+  }
 
-    return scaling * translation;
+  color4f renderer::get_output_color(color4f color) const {
+    return m_srgb ? to_linear(color) : color;
   }
 
-  void renderer::draw(const vertex *vertices, std::size_t count, int primitive) {
+  bool renderer::prepare_draw(uint32_t program) {
     // set viewport
 
     vec2i size = get_size();
     glViewport(0, 0, size.width, size.height);
 
+    glUseProgram(program);
+
     // set transformation matrix
 
-    mat3f transform = get_view_matrix();
+    mat3f transform = to_mat3(get_view_transform());
 
-    GLint loc = glGetUniformLocation(m_program, "u_transform");
+    GLint loc = get_uniform_location(program, "u_transform");
 
     if (loc == -1) {
-      std::cerr << "Uniform not found" << std::endl;
-      return;
+      return false;
     }
 
     glUniformMatrix3fv(loc, 1, GL_FALSE, &transform.data[0][0]);
+    return true;
+  }
 
-    // send data
-
-    glUseProgram(m_program);
-
-    GLint position_loc = glGetAttribLocation(m_program, "a_position");
-
-    if (loc == -1) {
-      std::cerr << "Attribute not found: a_position" << std::endl;
+  void renderer::draw(const vertex *vertices, std::size_t count, int primitive) {
+    if (!prepare_draw(m_program)) {
       return;
     }
 
-    GLint color_loc = glGetAttribLocation(m_program, "a_color");
+    GLint position_loc = get_attribute_location(m_program, "a_position");
+    GLint color_loc = get_attribute_location(m_program, "a_color");
 
-    if (loc == -1) {
-      std::cerr << "Attribute not found: a_color" << std::endl;
+    if (position_loc == -1 || color_loc == -1) {
       return;
     }
 
+    // send data
+
     glEnableVertexAttribArray(position_loc);
     glEnableVertexAttribArray(color_loc);
 
@@ -323,4 +932,39 @@ namespace hmi {
     glDisableVertexAttribArray(color_loc);
   }
 
+  void renderer::draw(const vec2f *positions, std::size_t count, color4f color, int primitive) {
+    draw_positions(positions, GL_FLOAT, count, color, primitive);
+  }
+
+  void renderer::draw(const vec2x *positions, std::size_t count, color4f color, int primitive) {
+    static_assert(sizeof(vec2x) == 2 * sizeof(GLfixed), "vec2x should be made of 2 GLfixed");
+    draw_positions(positions, GL_FIXED, count, color, primitive);
+  }
+
+  void renderer::draw_positions(const void *positions, int type, std::size_t count, color4f color, int primitive) {
+    if (!prepare_draw(m_program)) {
+      return;
+    }
+
+    color = get_output_color(color);
+
+    GLint position_loc = get_attribute_location(m_program, "a_position");
+    GLint color_loc = get_attribute_location(m_program, "a_color");
+
+    if (position_loc == -1 || color_loc == -1) {
+      return;
+    }
+
+    // send data, the color is a constant attribute
+
+    glEnableVertexAttribArray(position_loc);
+    glVertexAttrib4f(color_loc, color.r, color.g, color.b, color.a);
+
+    glVertexAttribPointer(position_loc, 2, type, GL_FALSE, 0, positions);
+
+    glDrawArrays(primitive, 0, count);
+
+    glDisableVertexAttribArray(position_loc);
+  }
+
 }
@@ -0,0 +1,128 @@
+#include <bits/tilemap.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "gl_defs.h"
+
+namespace hmi {
+
+  namespace {
+
+    constexpr std::size_t PALETTE_SIZE = 256;
+
+    std::uint8_t to_byte(float component) {
+      return static_cast<std::uint8_t>(std::clamp(component, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+  }
+
+  // The tiles are stored by chunks of chunk_size x chunk_size tiles. A chunk
+  // gets its texture the first time it is visible, and it is uploaded again
+  // only if one of its tiles has changed since the last upload.
+
+  tilemap::tilemap(vec2i size, span<const color4f> palette)
+  : m_size(size)
+  , m_chunk_count((size.width + chunk_size - 1) / chunk_size, (size.height + chunk_size - 1) / chunk_size)
+  , m_palette_texture(0)
+  , m_chunks(static_cast<std::size_t>(m_chunk_count.width) * static_cast<std::size_t>(m_chunk_count.height))
+  {
+    assert(size.width > 0 && size.height > 0);
+
+    for (auto& chunk : m_chunks) {
+      chunk.texture = 0;
+      chunk.dirty = true;
+      std::memset(chunk.tiles, 0, sizeof chunk.tiles);
+    }
+
+    glGenTextures(1, &m_palette_texture);
+    glBindTexture(GL_TEXTURE_2D, m_palette_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    set_palette(palette);
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  tilemap::~tilemap() {
+    for (auto& chunk : m_chunks) {
+      if (chunk.texture != 0) {
+        glDeleteTextures(1, &chunk.texture);
+      }
+    }
+
+    if (m_palette_texture != 0) {
+      glDeleteTextures(1, &m_palette_texture);
+    }
+  }
+
+  void tilemap::set_palette(span<const color4f> palette) {
+    assert(palette.size() <= PALETTE_SIZE);
+
+    std::uint8_t lut[PALETTE_SIZE * 4] = { };
+
+    for (std::size_t i = 0; i < palette.size(); ++i) {
+      for (std::size_t j = 0; j < 4; ++j) {
+        lut[4 * i + j] = to_byte(palette[i][j]);
+      }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_palette_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PALETTE_SIZE, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, lut);
+  }
+
+  void tilemap::set_tile(vec2i position, std::uint8_t index) {
+    assert(0 <= position.x && position.x < m_size.width);
+    assert(0 <= position.y && position.y < m_size.height);
+
+    chunk& current = m_chunks[(position.y / chunk_size) * m_chunk_count.width + position.x / chunk_size];
+    std::uint8_t& tile = current.tiles[(position.y % chunk_size) * chunk_size + position.x % chunk_size];
+
+    if (tile != index) {
+      tile = index;
+      current.dirty = true;
+    }
+  }
+
+  std::uint8_t tilemap::get_tile(vec2i position) const {
+    assert(0 <= position.x && position.x < m_size.width);
+    assert(0 <= position.y && position.y < m_size.height);
+
+    const chunk& current = m_chunks[(position.y / chunk_size) * m_chunk_count.width + position.x / chunk_size];
+    return current.tiles[(position.y % chunk_size) * chunk_size + position.x % chunk_size];
+  }
+
+  void tilemap::fill(std::uint8_t index) {
+    for (auto& chunk : m_chunks) {
+      std::memset(chunk.tiles, index, sizeof chunk.tiles);
+      chunk.dirty = true;
+    }
+  }
+
+  uint32_t tilemap::get_chunk_texture(vec2i position) {
+    chunk& current = m_chunks[position.y * m_chunk_count.width + position.x];
+
+    if (current.texture == 0) {
+      glGenTextures(1, &current.texture);
+      glBindTexture(GL_TEXTURE_2D, current.texture);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      current.dirty = true;
+    }
+
+    if (current.dirty) {
+      glBindTexture(GL_TEXTURE_2D, current.texture);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, chunk_size, chunk_size, 0, GL_ALPHA, GL_UNSIGNED_BYTE, current.tiles);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      current.dirty = false;
+    }
+
+    return current.texture;
+  }
+
+}
@@ -0,0 +1,194 @@
+#include <bits/trace_buffer.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace hmi {
+
+  namespace {
+
+    std::size_t round_to_power_of_two(std::size_t capacity) {
+      std::size_t result = 1;
+
+      while (result < capacity) {
+        result <<= 1;
+      }
+
+      return result;
+    }
+
+  }
+
+  // The samples are stored in a ring buffer whose capacity is a power of
+  // two. The level k of the pyramid (k >= 1) stores the minimum and the
+  // maximum of each block of 2^k samples. The blocks are aligned on the
+  // absolute index of the samples, so a block of the ring always holds the
+  // most recent block of samples that maps to it.
+
+  trace_buffer::trace_buffer(std::size_t capacity, float origin, float step)
+  : m_origin(origin)
+  , m_step(step)
+  , m_count(0)
+  , m_samples(round_to_power_of_two(capacity), 0.0f)
+  {
+    assert(step > 0.0f);
+
+    for (std::size_t blocks = m_samples.size() / 2; blocks > 0; blocks /= 2) {
+      m_levels.emplace_back(blocks, range{ 0.0f, 0.0f });
+    }
+  }
+
+  std::size_t trace_buffer::get_size() const {
+    return static_cast<std::size_t>(m_count - get_first_index());
+  }
+
+  float trace_buffer::get_first_x() const {
+    return get_x(get_first_index());
+  }
+
+  float trace_buffer::get_last_x() const {
+    return m_count == 0 ? get_x(0) : get_x(m_count - 1);
+  }
+
+  void trace_buffer::clear() {
+    m_count = 0;
+  }
+
+  void trace_buffer::append(float value) {
+    const std::uint64_t index = m_count++;
+    const std::size_t mask = m_samples.size() - 1;
+
+    m_samples[index & mask] = value;
+
+    for (std::size_t k = 1; k <= m_levels.size(); ++k) {
+      range& block = m_levels[k - 1][(index >> k) & (mask >> k)];
+
+      if ((index & ((std::uint64_t(1) << k) - 1)) == 0) {
+        // first sample of a new block
+        block.min = block.max = value;
+        continue;
+      }
+
+      if (block.min <= value && value <= block.max) {
+        // the upper levels already contain this block
+        break;
+      }
+
+      block.min = std::min(block.min, value);
+      block.max = std::max(block.max, value);
+    }
+  }
+
+  void trace_buffer::append(span<const float> values) {
+    for (float value : values) {
+      append(value);
+    }
+  }
+
+  void trace_buffer::decimate(float left, float right, std::size_t columns, std::vector<vec2f>& result) const {
+    if (m_count == 0 || columns == 0 || !(left < right)) {
+      return;
+    }
+
+    const std::uint64_t first = get_first_index();
+    const std::uint64_t last = m_count;
+
+    auto index_of = [&](float x) {
+      double index = std::ceil((static_cast<double>(x) - m_origin) / m_step);
+      index = std::clamp(index, static_cast<double>(first), static_cast<double>(last));
+      return static_cast<std::uint64_t>(index);
+    };
+
+    auto push_sample = [&](std::uint64_t index) {
+      result.emplace_back(get_x(index), get_sample(index));
+    };
+
+    const float column_width = (right - left) / columns;
+
+    // one sample before the view
+
+    std::uint64_t begin = index_of(left);
+    const std::uint64_t stop = index_of(right);
+
+    if (begin > first) {
+      push_sample(begin - 1);
+    }
+
+    for (std::size_t column = 0; column < columns; ++column) {
+      // with the rounding, a column boundary may go beyond the right edge
+      std::uint64_t end = (column + 1 == columns) ? stop : std::clamp(index_of(left + (column + 1) * column_width), begin, stop);
+
+      if (end - begin <= 2) {
+        for (std::uint64_t index = begin; index < end; ++index) {
+          push_sample(index);
+        }
+      } else {
+        range block = get_range(begin, end);
+
+        float first_x = get_x(begin);
+        float last_x = get_x(end - 1);
+
+        // keep the overall direction of the trace inside the column
+        if (get_sample(begin) <= get_sample(end - 1)) {
+          result.emplace_back(first_x, block.min);
+          result.emplace_back(last_x, block.max);
+        } else {
+          result.emplace_back(first_x, block.max);
+          result.emplace_back(last_x, block.min);
+        }
+      }
+
+      begin = end;
+    }
+
+    // one sample after the view
+
+    if (begin < last) {
+      push_sample(begin);
+    }
+  }
+
+  std::uint64_t trace_buffer::get_first_index() const {
+    return m_count > m_samples.size() ? m_count - m_samples.size() : 0;
+  }
+
+  float trace_buffer::get_x(std::uint64_t index) const {
+    return static_cast<float>(m_origin + static_cast<double>(index) * m_step);
+  }
+
+  float trace_buffer::get_sample(std::uint64_t index) const {
+    return m_samples[index & (m_samples.size() - 1)];
+  }
+
+  trace_buffer::range trace_buffer::get_range(std::uint64_t begin, std::uint64_t end) const {
+    const std::size_t mask = m_samples.size() - 1;
+
+    range result = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+
+    while (begin < end) {
+      // find the largest aligned block that starts at begin and fits in the range
+      std::size_t k = 0;
+
+      while (k < m_levels.size() && (begin & ((std::uint64_t(2) << k) - 1)) == 0 && begin + (std::uint64_t(2) << k) <= end) {
+        ++k;
+      }
+
+      if (k == 0) {
+        float value = get_sample(begin);
+        result.min = std::min(result.min, value);
+        result.max = std::max(result.max, value);
+      } else {
+        const range& block = m_levels[k - 1][(begin >> k) & (mask >> k)];
+        result.min = std::min(result.min, block.min);
+        result.max = std::max(result.max, block.max);
+      }
+
+      begin += std::uint64_t(1) << k;
+    }
+
+    return result;
+  }
+
+}
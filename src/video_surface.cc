@@ -0,0 +1,159 @@
+#include <bits/video_surface.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include "gl_defs.h"
+
+namespace hmi {
+
+  namespace {
+
+    uint32_t create_plane_texture() {
+      GLuint texture = 0;
+      glGenTextures(1, &texture);
+      glBindTexture(GL_TEXTURE_2D, texture);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      return texture;
+    }
+
+    void upload_plane(uint32_t texture, GLenum format, vec2i size, const std::uint8_t *data) {
+      glBindTexture(GL_TEXTURE_2D, texture);
+      glTexImage2D(GL_TEXTURE_2D, 0, format, size.width, size.height, 0, format, GL_UNSIGNED_BYTE, data);
+    }
+
+  }
+
+  // The producer and the renderer each own one of the three frames, the
+  // third one is shared. The index of the shared frame is exchanged
+  // atomically, with a flag telling if it holds a frame that has not been
+  // consumed yet. So neither side ever waits for the other: the producer
+  // overwrites the shared frame if the renderer is late, and the renderer
+  // keeps its current frame if the producer is late.
+  //
+  // The planes of a frame are uploaded in the textures that are not
+  // displayed, and the two sets of textures are swapped afterwards.
+
+  video_surface::video_surface(vec2i size, video_format format)
+  : m_size(size)
+  , m_format(format)
+  , m_shared(2)
+  , m_produced(0)
+  , m_consumed(1)
+  , m_planes{}
+  , m_current(0)
+  {
+    assert(size.width > 0 && size.height > 0);
+
+    vec2i chroma_size = get_chroma_size();
+    std::size_t frame_size = static_cast<std::size_t>(size.width) * size.height + 2 * static_cast<std::size_t>(chroma_size.width) * chroma_size.height;
+
+    for (auto& frame : m_frames) {
+      frame.resize(frame_size, 0);
+    }
+
+    for (auto& planes : m_planes) {
+      planes.y = create_plane_texture();
+      planes.u = create_plane_texture();
+
+      if (m_format == video_format::i420) {
+        planes.v = create_plane_texture();
+      } else {
+        planes.v = planes.u; // the interleaved UV plane is used for both U and V
+      }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  video_surface::~video_surface() {
+    for (auto& planes : m_planes) {
+      if (planes.v != planes.u) {
+        glDeleteTextures(1, &planes.v);
+      }
+
+      glDeleteTextures(1, &planes.u);
+      glDeleteTextures(1, &planes.y);
+    }
+  }
+
+  void video_surface::submit(span<const std::uint8_t> y, span<const std::uint8_t> u, span<const std::uint8_t> v) {
+    assert(m_format == video_format::i420);
+
+    vec2i chroma_size = get_chroma_size();
+    std::size_t luma_bytes = static_cast<std::size_t>(m_size.width) * m_size.height;
+    std::size_t chroma_bytes = static_cast<std::size_t>(chroma_size.width) * chroma_size.height;
+
+    assert(y.size() == luma_bytes);
+    assert(u.size() == chroma_bytes);
+    assert(v.size() == chroma_bytes);
+
+    auto& frame = m_frames[m_produced];
+    std::copy(y.begin(), y.end(), frame.begin());
+    std::copy(u.begin(), u.end(), frame.begin() + luma_bytes);
+    std::copy(v.begin(), v.end(), frame.begin() + luma_bytes + chroma_bytes);
+
+    publish();
+  }
+
+  void video_surface::submit(span<const std::uint8_t> y, span<const std::uint8_t> uv) {
+    assert(m_format == video_format::nv12);
+
+    vec2i chroma_size = get_chroma_size();
+    std::size_t luma_bytes = static_cast<std::size_t>(m_size.width) * m_size.height;
+
+    assert(y.size() == luma_bytes);
+    assert(uv.size() == 2 * static_cast<std::size_t>(chroma_size.width) * chroma_size.height);
+
+    auto& frame = m_frames[m_produced];
+    std::copy(y.begin(), y.end(), frame.begin());
+    std::copy(uv.begin(), uv.end(), frame.begin() + luma_bytes);
+
+    publish();
+  }
+
+  void video_surface::publish() {
+    unsigned previous = m_shared.exchange(m_produced | FRESH, std::memory_order_acq_rel);
+    m_produced = previous & ~FRESH;
+  }
+
+  const video_surface::planes& video_surface::get_planes() {
+    if ((m_shared.load(std::memory_order_relaxed) & FRESH) == 0) {
+      return m_planes[m_current];
+    }
+
+    unsigned previous = m_shared.exchange(m_consumed, std::memory_order_acq_rel);
+    m_consumed = previous & ~FRESH;
+
+    // upload the new frame in the textures that are not displayed
+
+    const std::uint8_t *frame = m_frames[m_consumed].data();
+    vec2i chroma_size = get_chroma_size();
+    std::size_t luma_bytes = static_cast<std::size_t>(m_size.width) * m_size.height;
+    std::size_t chroma_bytes = static_cast<std::size_t>(chroma_size.width) * chroma_size.height;
+
+    unsigned next = 1 - m_current;
+    const planes& textures = m_planes[next];
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    upload_plane(textures.y, GL_LUMINANCE, m_size, frame);
+
+    if (m_format == video_format::i420) {
+      upload_plane(textures.u, GL_LUMINANCE, chroma_size, frame + luma_bytes);
+      upload_plane(textures.v, GL_ALPHA, chroma_size, frame + luma_bytes + chroma_bytes);
+    } else {
+      upload_plane(textures.u, GL_LUMINANCE_ALPHA, chroma_size, frame + luma_bytes);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_current = next;
+    return textures;
+  }
+
+}
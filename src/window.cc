@@ -108,6 +108,9 @@ namespace hmi {
       SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
     }
 
+    // must also be set before window creation, but may change between windows
+    SDL_GL_SetAttribute(SDL_GL_FRAMEBUFFER_SRGB_CAPABLE, (hints & window_flags::srgb) != window_flags::none ? 1 : 0);
+
     std::string title_string(title);
     auto flags = compute_sdl_flags(hints);
     m_window = SDL_CreateWindow(title_string.data(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, size.width, size.height, flags);
@@ -0,0 +1,110 @@
+#include <type_traits>
+
+#include <geometry>
+
+// compile-time checks of the constexpr surface of <geometry>: the test is
+// that this file compiles
+
+namespace hmi {
+
+  namespace {
+
+    constexpr vec2f zero2f{};
+    static_assert(zero2f[0] == 0.0f && zero2f[1] == 0.0f);
+
+    constexpr vec2i v2i(1, 2);
+    constexpr vec2f v2f(v2i);
+    static_assert(v2f == vec2f(1.0f, 2.0f));
+    static_assert(v2i + v2i == vec2i(2, 4));
+    static_assert(v2i - vec2i(1, 1) == vec2i(0, 1));
+    static_assert(3 * v2i == vec2i(3, 6));
+    static_assert(vec2i(4, 8) / 2 == vec2i(2, 4));
+    static_assert(-v2i == vec2i(-1, -2));
+
+    constexpr vec<int, 5> make_vec5() {
+      vec<int, 5> result{};
+
+      for (std::size_t i = 0; i < 5; ++i) {
+        result[i] = static_cast<int>(i);
+      }
+
+      return result;
+    }
+
+    static_assert((make_vec5() * 2)[4] == 8);
+    static_assert(vec<double, 5>(make_vec5())[3] == 3.0);
+
+    constexpr vec4f v4f(1.0f, 2.0f, 3.0f, 4.0f);
+    static_assert((v4f + v4f) * 0.5f == v4f);
+
+    constexpr mat3i m3i(1, 2, 0, 0, 1, 3, 0, 0, 1);
+    constexpr mat3i id3i(1, 0, 0, 0, 1, 0, 0, 0, 1);
+    static_assert(m3i * id3i == m3i);
+    static_assert(transpose(transpose(m3i)) == m3i);
+    static_assert(transpose(m3i)(1, 0) == 2);
+    static_assert(m3i * vec3i(1, 1, 1) == vec3i(3, 4, 1));
+    static_assert(mat3f(m3i)(1, 2) == 3.0f);
+
+    constexpr mat2x3i m23i(1, 2, 3, 4, 5, 6);
+    static_assert(m23i * id3i == m23i);
+    static_assert(m23i * vec3i(1, 0, 1) == vec2i(4, 10));
+    static_assert(vec2i(1, 1) * m23i == vec3i(5, 7, 9));
+    static_assert(transpose(m23i) * vec2i(1, 1) == vec3i(5, 7, 9));
+    static_assert(transform_point(m23i, vec2i(1, 1)) == vec2i(6, 15));
+    static_assert(transform2<int>::translation(vec2i(1, 2)) * transform2<int>::scaling(vec2i(2, 2)) == mat2x3i(2, 0, 1, 0, 2, 2));
+    static_assert(invert(transform2<double>::scaling(vec2d(2.0, 4.0))) == transform2d::scaling(vec2d(0.5, 0.25)));
+
+    constexpr cubic_bezier2f curve = cubic_bezier2f::from_catmull_rom(vec2f(0.0f, 0.0f), vec2f(1.0f, 0.0f), vec2f(2.0f, 0.0f), vec2f(3.0f, 0.0f));
+    static_assert(evaluate(curve, 0.0f) == vec2f(1.0f, 0.0f) && evaluate(curve, 1.0f) == vec2f(2.0f, 0.0f));
+    static_assert(evaluate(curve, 0.5f) == vec2f(1.5f, 0.0f));
+
+    constexpr mat2d m2d(4.0, 2.0, 2.0, 3.0);
+    static_assert(m2d * invert(m2d) == mat2d(1.0, 0.0, 0.0, 1.0));
+
+    constexpr mat3d m3d(2.0, 0.0, 4.0, 0.0, 4.0, 8.0, 0.0, 0.0, 1.0);
+    static_assert(m3d * invert(m3d) == mat3d(1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0));
+
+    constexpr mat4d m4d(2.0, 0.0, 0.0, 1.0, 0.0, 4.0, 0.0, 2.0, 0.0, 0.0, 8.0, 3.0, 0.0, 0.0, 0.0, 1.0);
+    static_assert(m4d * invert(m4d) == mat4d(1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0));
+    static_assert(invert_affine(m4d) == invert(m4d));
+    static_assert(invert_affine(m3d) == invert(m3d));
+    static_assert(invert_rigid(mat3i(0, -1, 2, 1, 0, 3, 0, 0, 1)) * mat3i(0, -1, 2, 1, 0, 3, 0, 0, 1) == id3i);
+
+    static_assert(transform_point(mat3f(2.0f, 0.0f, 1.0f, 0.0f, 2.0f, -1.0f, 0.0f, 0.0f, 1.0f), vec2f(1.0f, 1.0f)) == vec2f(3.0f, 1.0f));
+
+    constexpr quatf half_turn_z(0.0f, 0.0f, 1.0f, 0.0f);
+    static_assert(quatf::identity() * half_turn_z == half_turn_z && half_turn_z * conjugate(half_turn_z) == quatf::identity());
+    static_assert(rotate(half_turn_z, vec3f(1.0f, 2.0f, 3.0f)) == vec3f(-1.0f, -2.0f, 3.0f));
+    static_assert(to_mat3(half_turn_z) * vec3f(1.0f, 2.0f, 3.0f) == vec3f(-1.0f, -2.0f, 3.0f));
+    static_assert(transform_point(to_mat4(quatf::identity(), vec3f(1.0f, 2.0f, 3.0f), vec3f(2.0f, 2.0f, 2.0f)), vec3f(1.0f, 1.0f, 1.0f)) == vec3f(3.0f, 4.0f, 5.0f));
+
+    static_assert(vec2i(lazy(v2i) + v2i * 2) == vec2i(3, 6));
+    static_assert(vec3i(lazy(m3i) * id3i * vec3i(1, 1, 1)) == vec3i(3, 4, 1));
+    static_assert(vec2i(lazy(v2i) + vec2i(1, 1) - 1) == v2i && mat3i(lazy(m3i) + id3i - id3i) == m3i);
+
+    constexpr bool check_sincos(float angle, float expected_sin, float expected_cos) {
+      float s = 0.0f, c = 0.0f;
+      fast_sincos(angle, s, c);
+      return s == expected_sin && c == expected_cos;
+    }
+
+    static_assert(check_sincos(0.0f, 0.0f, 1.0f));
+
+    static_assert(std::is_same_v<std::common_type_t<fixed16_16, int>, fixed16_16>);
+    static_assert(std::is_same_v<std::common_type_t<float, fixed16_16>, float>);
+
+    constexpr vec2x v2x(fixed16_16(1.5), 2);
+    static_assert(v2x * 2 == vec2x(3, 4));
+    static_assert(v2x / 2 == vec2x(fixed16_16(0.75), 1));
+    static_assert(dot(v2x, v2x) == fixed16_16(6.25));
+    static_assert(transform_point(mat3<fixed16_16>(1, 0, 5, 0, 1, -3, 0, 0, 1), v2x) == vec2x(fixed16_16(6.5), -1));
+    static_assert(fixed16_16(30000) * 30000 == fixed16_16::max());
+    static_assert(fixed16_16(1) / 0 == fixed16_16::max());
+    static_assert(round(fixed16_16(-1.5)) == -2 && floor(fixed16_16(-1.25)) == -2 && ceil(fixed16_16(-1.25)) == -1);
+
+  }
+
+}
+
+int main() {
+}